@@ -82,6 +82,8 @@ struct Triangulation;
 #include <mpblocks/clarkson93/Indexed.h>
 #include <mpblocks/clarkson93/PQueue.h>
 #include <mpblocks/clarkson93/StaticStack.h>
+#include <mpblocks/clarkson93/StaticVector.h>
+#include <mpblocks/clarkson93/Predicates.h>
 #include <mpblocks/clarkson93/HorizonRidge.h>
 #include <mpblocks/clarkson93/Simplex.h>
 #include <mpblocks/clarkson93/Simplex2.h>
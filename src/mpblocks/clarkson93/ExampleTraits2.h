@@ -169,6 +169,16 @@ struct ExampleTraits2
             base_t::emplace_back( );
             return &base_t::back();
         }
+
+        /// construct @p n objects in consecutive slots and return the
+        /// pointer to the first, used to hand out disjoint blocks to threads
+        SimplexRef create( std::size_t n )
+        {
+            assert( base_t::size() + n <= base_t::capacity() );
+            std::size_t first = base_t::size();
+            base_t::resize( first + n );
+            return base_t::data() + first;
+        }
     };
 
     /// the triangulation provides some static callbacks for when hull faces
@@ -0,0 +1,292 @@
+/*
+ *  Copyright (C) 2012 Josh Bialkowski (jbialk@mit.edu)
+ *
+ *  This file is part of mpblocks.
+ *
+ *  mpblocks is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  mpblocks is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with mpblocks.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ *  @file   mpblocks/clarkson93/Predicates.h
+ *
+ *  @date   Mar 21, 2017
+ *  @author Jiahuan Liu (jiahaun.liu@outlook.com)
+ *  @brief  filtered exact orientation predicates (Shewchuk '97)
+ */
+
+#ifndef MPBLOCKS_CLARKSON93_PREDICATES_H_
+#define MPBLOCKS_CLARKSON93_PREDICATES_H_
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace   mpblocks {
+namespace clarkson93 {
+namespace predicates {
+
+/// counts of orientation tests, and of those the floating point filter
+/// could not decide so they were computed exactly
+struct Stats
+{
+    uint64_t tests;
+    uint64_t exact;
+};
+
+/// counts of one thread, only that thread writes them, so counting needs
+/// no read-modify-write, while stats() and resetStats() read and clear
+/// every thread's counts
+struct Counter
+{
+    std::atomic<uint64_t> tests;
+    std::atomic<uint64_t> exact;
+
+    Counter(): tests(0), exact(0) {}
+
+    static void bump( std::atomic<uint64_t>& n )
+    {
+        n.store( n.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed );
+    }
+};
+
+inline std::mutex& counterLock()
+{
+    static std::mutex lock;
+    return lock;
+}
+
+/// counters of every thread that has counted
+inline std::vector<Counter*>& counters()
+{
+    static std::vector<Counter*> list;
+    return list;
+}
+
+/// a new counter in counters(), kept out of line as it runs once per thread
+__attribute__((noinline)) inline Counter* newCounter()
+{
+    Counter* counter = new Counter();
+    std::lock_guard<std::mutex> guard( counterLock() );
+    counters().push_back( counter );
+    return counter;
+}
+
+/// the calling thread's counter, registered on first use; counters are
+/// never freed, so the counts of exited threads stay in counters() and
+/// the lookup is a plain thread local pointer without a guard
+inline Counter& localCounter()
+{
+    static thread_local Counter* local = nullptr;
+    if( __builtin_expect( !local, 0 ) )
+        local = newCounter();
+    return *local;
+}
+
+/// exact while no thread is counting, a thread that counts meanwhile may
+/// or may not be included
+inline Stats stats()
+{
+    std::lock_guard<std::mutex> guard( counterLock() );
+    Stats s = {0, 0};
+    for( Counter* c : counters() )
+    {
+        s.tests += c->tests.load(std::memory_order_relaxed);
+        s.exact += c->exact.load(std::memory_order_relaxed);
+    }
+    return s;
+}
+
+/// clear the counts of every thread, meant for when no thread is counting
+inline void resetStats()
+{
+    std::lock_guard<std::mutex> guard( counterLock() );
+    for( Counter* c : counters() )
+    {
+        c->tests.store(0, std::memory_order_relaxed);
+        c->exact.store(0, std::memory_order_relaxed);
+    }
+}
+
+/// a * b = p + e exactly
+inline void twoProduct( double a, double b, double& p, double& e )
+{
+    p = a * b;
+    e = std::fma( a, b, -p );
+}
+
+/// a + b = s + e exactly
+inline void twoSum( double a, double b, double& s, double& e )
+{
+    s = a + b;
+    double bv = s - a;
+    double av = s - bv;
+    e = (a - av) + (b - bv);
+}
+
+/// h = e + b, e and h are nonoverlapping expansions of increasing magnitude
+/// without zero components, h may alias e
+/// @return length of h
+inline int growExpansion( int n, const double* e, double b, double* h )
+{
+    double q = b, hh;
+    int k = 0;
+    for( int i = 0; i < n; i++ )
+    {
+        twoSum( q, e[i], q, hh );
+        if( hh != 0 )
+            h[k++] = hh;
+    }
+    if( q != 0 || k == 0 )
+        h[k++] = q;
+    return k;
+}
+
+/// sign of orient2d by summing its six products exactly
+template <typename P>
+int orient2dExact( const P& a, const P& b, const P& c )
+{
+    const double ax = a[0], ay = a[1], bx = b[0], by = b[1],
+                 cx = c[0], cy = c[1];
+    const double terms[6][2] = { {ax, by}, {-ax, cy}, {-ay, bx},
+                                 {ay, cx}, {bx, cy}, {-by, cx} };
+
+    double h[12];
+    int n = 0;
+    for( int i = 0; i < 6; i++ )
+    {
+        double p, e;
+        twoProduct( terms[i][0], terms[i][1], p, e );
+        n = growExpansion( n, h, e, h );
+        n = growExpansion( n, h, p, h );
+    }
+
+    double top = h[n-1];
+    return (top > 0) - (top < 0);
+}
+
+/// a * b * c = h[0] + ... + h[3] exactly
+inline void threeProduct( double a, double b, double c, double* h )
+{
+    double p, e;
+    twoProduct( a, b, p, e );
+    twoProduct( p, c, h[0], h[1] );
+    twoProduct( e, c, h[2], h[3] );
+}
+
+/// sign of orient3d as the 4x4 determinant of the rows (p, 1), summing its
+/// 24 triple products exactly
+template <typename P>
+int orient3dExact( const P& a, const P& b, const P& c, const P& d )
+{
+    // cofactor expansion along the column of ones
+    const P* rows[4] = { &a, &b, &c, &d };
+    const int sign[4] = { -1, 1, -1, 1 };
+    static const int perm[6][4] = { {0,1,2, 1}, {0,2,1,-1}, {1,0,2,-1},
+                                    {1,2,0, 1}, {2,0,1, 1}, {2,1,0,-1} };
+
+    double h[96];
+    int n = 0;
+    for( int i = 0; i < 4; i++ )
+    {
+        const P* m[3];
+        for( int j = 0, k = 0; j < 4; j++ )
+            if( j != i )
+                m[k++] = rows[j];
+
+        for( int q = 0; q < 6; q++ )
+        {
+            double t[4];
+            threeProduct( sign[i] * perm[q][3] * (double)(*m[0])[perm[q][0]],
+                          (double)(*m[1])[perm[q][1]],
+                          (double)(*m[2])[perm[q][2]], t );
+            for( int r = 0; r < 4; r++ )
+                n = growExpansion( n, h, t[r], h );
+        }
+    }
+
+    double top = h[n-1];
+    return (top > 0) - (top < 0);
+}
+
+/// sign of (b - a) x (c - a): > 0 if a->b->c turns left, 0 if collinear,
+/// decided in floating point whenever the result is larger than its error
+/// bound, exactly otherwise
+template <typename P>
+int orient2d( const P& a, const P& b, const P& c )
+{
+    // (3 + 16 eps) eps of Shewchuk, eps being half a double ulp
+    static const double errBound = (3.0 + 16.0 * 1.1102230246251565e-16)
+                                    * 1.1102230246251565e-16;
+
+    Counter& counter = localCounter();
+    Counter::bump( counter.tests );
+
+    const double detLeft  = ((double)a[0] - c[0]) * ((double)b[1] - c[1]);
+    const double detRight = ((double)a[1] - c[1]) * ((double)b[0] - c[0]);
+    const double det      = detLeft - detRight;
+    const double bound    = errBound * (std::fabs(detLeft) + std::fabs(detRight));
+
+    if( det > bound )
+        return 1;
+    if( -det > bound )
+        return -1;
+
+    Counter::bump( counter.exact );
+    return orient2dExact( a, b, c );
+}
+
+/// sign of det(a - d, b - d, c - d): > 0 if d lies below the plane through
+/// a, b, c, which are then counter-clockwise seen from above, 0 if coplanar;
+/// filtered like orient2d
+template <typename P>
+int orient3d( const P& a, const P& b, const P& c, const P& d )
+{
+    // (7 + 56 eps) eps of Shewchuk
+    static const double errBound = (7.0 + 56.0 * 1.1102230246251565e-16)
+                                    * 1.1102230246251565e-16;
+
+    Counter& counter = localCounter();
+    Counter::bump( counter.tests );
+
+    const double adx = (double)a[0] - d[0], ady = (double)a[1] - d[1], adz = (double)a[2] - d[2];
+    const double bdx = (double)b[0] - d[0], bdy = (double)b[1] - d[1], bdz = (double)b[2] - d[2];
+    const double cdx = (double)c[0] - d[0], cdy = (double)c[1] - d[1], cdz = (double)c[2] - d[2];
+
+    const double bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+    const double cdxady = cdx * ady, adxcdy = adx * cdy;
+    const double adxbdy = adx * bdy, bdxady = bdx * ady;
+
+    const double det = adz * (bdxcdy - cdxbdy)
+                     + bdz * (cdxady - adxcdy)
+                     + cdz * (adxbdy - bdxady);
+    const double permanent = (std::fabs(bdxcdy) + std::fabs(cdxbdy)) * std::fabs(adz)
+                           + (std::fabs(cdxady) + std::fabs(adxcdy)) * std::fabs(bdz)
+                           + (std::fabs(adxbdy) + std::fabs(bdxady)) * std::fabs(cdz);
+    const double bound = errBound * permanent;
+
+    if( det > bound )
+        return 1;
+    if( -det > bound )
+        return -1;
+
+    Counter::bump( counter.exact );
+    return orient3dExact( a, b, c, d );
+}
+
+} // namespace predicates
+} // namespace clarkson93
+} // namespace mpblocks
+
+#endif // MPBLOCKS_CLARKSON93_PREDICATES_H_
@@ -73,12 +73,16 @@ struct Simplex2
     PointRef    V[NDim+1];   ///< vertices of the simplex
     SimplexRef  N[NDim+1];   ///< simplices which share a facet
     BitSet      sets;        ///< sets this simplex is a member of
+    uint32_t    xvWalk;      ///< epoch of the x-visible walk that last queued it
+    uint32_t    xvHull;      ///< epoch of the x-visible hull fill that last found it
 
     Point   n;  ///< normal vector of base facet
     Scalar  o;  ///< offset of base facet inequality hyperplane
 
     Simplex2( PointRef pNull, SimplexRef sNull ):
         iPeak(0),
+        xvWalk(0),
+        xvHull(0),
         o(0)
     {
         for(int i=0; i < NDim+1; i++)
@@ -289,6 +293,28 @@ struct SimplexOps
     /// compute the base facet normal and offset
     void computeBase( Simplex& S, Deref& deref );
 
+    /// normal of the hyperplane through the rows of A, up to scale, chosen at
+    /// compile time: closed form in 2 and 3 dimensions, cofactors of the
+    /// edge vectors up to MAX_COFACTOR_DIM, their kernel by LU beyond
+    typedef Eigen::Matrix<Scalar,NDim,NDim> Matrix;
+    template <unsigned int D>
+    using DimTag = std::integral_constant<unsigned int,D>;
+
+    /// largest dimension whose cofactors are at most 4x4, which Eigen
+    /// evaluates in closed form
+    static const unsigned int MAX_COFACTOR_DIM = 5;
+
+    static void baseNormal( const Matrix& A, Point& n, DimTag<2> );
+    static void baseNormal( const Matrix& A, Point& n, DimTag<3> );
+    template <unsigned int D>
+    static void baseNormal( const Matrix& A, Point& n, DimTag<D> );
+
+    /// n[k] = (-1)^k det(E without column k), E holding the edge vectors
+    static void baseCofactor( const Matrix& A, Point& n );
+
+    /// n spans the kernel of E, by full pivoting LU
+    static void baseKernel( const Matrix& A, Point& n );
+
     /// orient the base facete normal by ensuring that the point x
     /// lies on the appropriate half-space
     /// @f$ n \cdot x \le c @f$ )
@@ -304,6 +330,16 @@ struct SimplexOps
     /// returns true if the base vertex is the anti origin
     bool isInfinite( const Simplex& S, PointRef antiOrigin );
 
+    /// sign of @f$ n \cdot x - c @f$ for the exact base facet, so 0 only if x
+    /// lies on it; in 2 and 3 dimensions it is decided by predicates::orient2d
+    /// and orient3d, otherwise by the floating point normal and offset
+    int baseSide( const Simplex& S, const Point& x );
+
+    /// sign of x against the facet of a finite simplex S across vertex i,
+    /// positive on the side of vertex i and 0 only if x lies on the facet;
+    /// decided as baseSide is, exactly in 2 and 3 dimensions
+    int facetSide( const Simplex& S, uint32_t i, const Point& x );
+
     /// returns true if x is on the inside of the base facet (i.e. x is in the
     /// same half space as the simplex)
     bool isVisible( const Simplex& S, const Point& x );
@@ -28,7 +28,7 @@
 #define MPBLOCKS_CLARKSON93_SIMPLEX2_HPP_
 
 #include <mpblocks/clarkson93.hpp>
-#include <map>
+#include <functional>
 
 namespace   mpblocks {
 namespace clarkson93 {
@@ -154,12 +154,14 @@ inline
 void SimplexOps<Traits>::neighborSharing(
         Simplex& S, Input first, Input last, Output out )
 {
+    // [first,last) is a sorted subset of the sorted vertex set, so walk both
+    // and never read past last
     for( unsigned int i=0; i < NDim+1; i++ )
     {
-        if( S.V[i] < *first )
-            *out++ = S.N[i];
-        else
+        if( first != last && S.V[i] == *first )
             first++;
+        else
+            *out++ = S.N[i];
     }
 }
 
@@ -210,48 +212,46 @@ template <class Traits>
 inline
 void SimplexOps<Traits>::finish( Simplex& S )
 {
+    //lucas 03/2017
+    // insertion sort of the NDim+1 vertex/neighbor pairs in place, the
+    // bounds are compile time constants so it unrolls without allocating
     PointRef peak = S.V[S.iPeak];
-    std::map<PointRef,SimplexRef> kv;
+    std::less<PointRef> less;
 
+    for( int i=1; i < NDim+1; i++ )
+    {
+        PointRef   v = S.V[i];
+        SimplexRef n = S.N[i];
+        int j = i;
+        for( ; j > 0 && less( v, S.V[j-1] ); j-- )
+        {
+            S.V[j] = S.V[j-1];
+            S.N[j] = S.N[j-1];
+        }
+        S.V[j] = v;
+        S.N[j] = n;
+    }
 
     for( int i=0; i < NDim+1; i++ )
-        kv[ S.V[i] ] = S.N[i];
-
-    int i=0;
-    for( auto pair: kv )
-    {
-        if( pair.first == peak )
+        if( S.V[i] == peak )
             S.iPeak = i;
-        S.V[i] = pair.first;
-        S.N[i] = pair.second;
-        i++;
-    }
 }
 
 template <class Traits>
 inline
 void SimplexOps<Traits>::computeBase( Simplex& S, Deref& deref )
 {
-    typedef Eigen::Matrix<Scalar,NDim,NDim> Matrix;
-    typedef Eigen::Matrix<Scalar,NDim,1>    Vector;
-
     Matrix A;
-    //Vector b;
 
     unsigned int j=0;
     for(unsigned int i=0; i < NDim+1; i++)
         if( i != S.iPeak )
             A.row(j++) = deref.point(S.V[i]);
-    /*b.setConstant(1);
-
-    // solve for the normal
-    S.n = A.fullPivLu().solve(b);
-    S.n.normalize();*/
 
     //lucas 03/2017
-    auto dx = A(0, 0) - A(1, 0);
-    auto dy = A(0, 1) - A(1, 1);
-    S.n[0] = dy, S.n[1] = -dx;
+    // the normal is found without solving A n = 1, which fails for facets
+    // through the origin
+    baseNormal( A, S.n, DimTag<NDim>() );
     S.n.normalize();
 
     // and then find the value of 'c' (hyperplane offset)
@@ -259,6 +259,68 @@ void SimplexOps<Traits>::computeBase( Simplex& S, Deref& deref )
     S.o = deref.point(S.V[j]).dot(S.n);
 }
 
+template <class Traits>
+inline
+void SimplexOps<Traits>::baseNormal( const Matrix& A, Point& n, DimTag<2> )
+{
+    auto dx = A(0, 0) - A(1, 0);
+    auto dy = A(0, 1) - A(1, 1);
+    n[0] = dy, n[1] = -dx;
+}
+
+template <class Traits>
+inline
+void SimplexOps<Traits>::baseNormal( const Matrix& A, Point& n, DimTag<3> )
+{
+    Point u = A.row(1) - A.row(0);
+    Point v = A.row(2) - A.row(0);
+    n = u.cross(v);
+}
+
+template <class Traits>
+template <unsigned int D>
+inline
+void SimplexOps<Traits>::baseNormal( const Matrix& A, Point& n, DimTag<D> )
+{
+    if( D <= MAX_COFACTOR_DIM )
+        baseCofactor( A, n );
+    else
+        baseKernel( A, n );
+}
+
+template <class Traits>
+inline
+void SimplexOps<Traits>::baseCofactor( const Matrix& A, Point& n )
+{
+    //lucas 03/2017
+    // the minors are fixed size, so for NDim <= MAX_COFACTOR_DIM determinant()
+    // is unrolled without pivoting
+    typedef Eigen::Matrix<Scalar,NDim-1,NDim-1> Minor;
+
+    Eigen::Matrix<Scalar,NDim-1,NDim> E;
+    for(unsigned int i=1; i < NDim; i++)
+        E.row(i-1) = A.row(i) - A.row(0);
+
+    Minor M;
+    for(unsigned int k=0; k < NDim; k++)
+    {
+        for(unsigned int j=0, c=0; j < NDim; j++)
+            if( j != k )
+                M.col(c++) = E.col(j);
+        n[k] = (k % 2 ? -1 : 1) * M.determinant();
+    }
+}
+
+template <class Traits>
+inline
+void SimplexOps<Traits>::baseKernel( const Matrix& A, Point& n )
+{
+    Eigen::Matrix<Scalar,NDim-1,NDim> E;
+    for(unsigned int i=1; i < NDim; i++)
+        E.row(i-1) = A.row(i) - A.row(0);
+    n = E.fullPivLu().kernel().col(0);
+}
+
 template <class Traits>
 inline
 void SimplexOps<Traits>::
@@ -271,7 +333,7 @@ void SimplexOps<Traits>::
     {
         case INSIDE:
         {
-            if( S.n.dot( x ) > S.o )
+            if( baseSide( S, x ) > 0 )
             {
                 S.n = -S.n;
                 S.o = -S.o;
@@ -281,7 +343,7 @@ void SimplexOps<Traits>::
 
         case OUTSIDE:
         {
-            if( S.n.dot( x ) < S.o )
+            if( baseSide( S, x ) < 0 )
             {
                 S.n = -S.n;
                 S.o = -S.o;
@@ -312,11 +374,88 @@ bool SimplexOps<Traits>::isInfinite( const Simplex& S, PointRef antiOrigin )
     return S.V[S.iPeak] == antiOrigin;
 }
 
+template <class Traits>
+inline
+int SimplexOps<Traits>::baseSide( const Simplex& S, const Point& x )
+{
+    if( NDim != 2 && NDim != 3 )
+    {
+        Scalar d = S.n.dot(x) - S.o;
+        return (d > 0) - (d < 0);
+    }
+
+    //lucas 03/2017
+    // n is the unnormalized normal r of the base facet, normalized and maybe
+    // negated, and r.(x - a) is an orientation determinant of the facet
+    // vertices and x, so it is decided exactly and n tells its sign
+    Deref deref;
+    const Point* f[NDim];
+    for( unsigned int i=0, j=0; i < NDim+1; i++ )
+        if( i != S.iPeak )
+            f[j++] = &deref.point( S.V[i] );
+
+    const Point& a = *f[0];
+    const Point& b = *f[1];
+    Scalar r;
+    int side;
+    if( NDim == 2 )
+    {
+        // r.(x - a) = orient2d(a, b, x)
+        r    = S.n[0] * (a[1] - b[1]) + S.n[1] * (b[0] - a[0]);
+        side = predicates::orient2d( a, b, x );
+    }
+    else
+    {
+        // r = (b - a) x (c - a), r.(x - a) = -orient3d(a, b, c, x)
+        const Point& c = *f[NDim-1];
+        const Scalar abx = b[0] - a[0], aby = b[1] - a[1], abz = b[2] - a[2];
+        const Scalar acx = c[0] - a[0], acy = c[1] - a[1], acz = c[2] - a[2];
+        r    = S.n[0] * (aby * acz - abz * acy)
+             + S.n[1] * (abz * acx - abx * acz)
+             + S.n[2] * (abx * acy - aby * acx);
+        side = -predicates::orient3d( a, b, c, x );
+    }
+    return r > 0 ? side : -side;
+}
+
+template <class Traits>
+inline
+int SimplexOps<Traits>::facetSide( const Simplex& S, uint32_t i, const Point& x )
+{
+    //lucas 03/2017
+    // the orientation of the facet vertices with x, against their
+    // orientation with vertex i
+    Deref deref;
+    const Point* f[NDim];
+    for( unsigned int k=0, j=0; k < NDim+1; k++ )
+        if( k != i )
+            f[j++] = &deref.point( S.V[k] );
+    const Point& v = deref.point( S.V[i] );
+
+    if( NDim == 2 )
+        return predicates::orient2d( *f[0], *f[1], x )
+             * predicates::orient2d( *f[0], *f[1], v );
+    if( NDim == 3 )
+        return predicates::orient3d( *f[0], *f[1], *f[NDim-1], x )
+             * predicates::orient3d( *f[0], *f[1], *f[NDim-1], v );
+
+    Matrix Ex, Ev;
+    for( unsigned int j=1; j < NDim; j++ )
+    {
+        Ex.row(j-1) = (*f[j] - *f[0]).transpose();
+        Ev.row(j-1) = (*f[j] - *f[0]).transpose();
+    }
+    Ex.row(NDim-1) = (x - *f[0]).transpose();
+    Ev.row(NDim-1) = (v - *f[0]).transpose();
+    Scalar d = Ex.determinant() * Ev.determinant();
+    return (d > 0) - (d < 0);
+}
+
 template <class Traits>
 inline
 bool SimplexOps<Traits>::isVisible( const Simplex& S, const Point& x )
 {
-    return ( S.n.dot(x) < S.o );
+    return baseSide( S, x ) < 0;
 }
 
 
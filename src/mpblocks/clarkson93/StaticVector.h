@@ -0,0 +1,97 @@
+/*
+ *  Copyright (C) 2012 Josh Bialkowski (jbialk@mit.edu)
+ *
+ *  This file is part of mpblocks.
+ *
+ *  mpblocks is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  mpblocks is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with mpblocks.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ *  @file   mpblocks/clarkson93/StaticVector.h
+ *
+ *  @date   Mar 22, 2017
+ *  @author Jiahuan Liu (jiahaun.liu@outlook.com)
+ *  @brief  fixed capacity vector living on the stack
+ */
+
+#ifndef MPBLOCKS_CLARKSON93_STATICVECTOR_H_
+#define MPBLOCKS_CLARKSON93_STATICVECTOR_H_
+
+#include <cassert>
+
+namespace   mpblocks {
+namespace clarkson93 {
+
+/// vector of at most N elements stored inline, so that the small per ridge
+/// sets of the horizon wedge need no heap allocation; supports enough of the
+/// std::vector interface for std::back_inserter and range for
+template <typename T, unsigned int N>
+class StaticVector
+{
+    public:
+        typedef T           value_type;
+        typedef T*          iterator;
+        typedef const T*    const_iterator;
+
+    private:
+        T               m_data[N];
+        unsigned int    m_size;
+
+    public:
+        StaticVector():
+            m_size(0)
+        {}
+
+        void push_back( const T& v )
+        {
+            assert( m_size < N );
+            m_data[m_size++] = v;
+        }
+
+        void pop_back()
+        {
+            assert( m_size > 0 );
+            m_size--;
+        }
+
+        /// insert v before pos, shifting the tail back by one
+        void insert( iterator pos, const T& v )
+        {
+            assert( m_size < N );
+            for( iterator it = end(); it != pos; --it )
+                *it = *(it-1);
+            *pos = v;
+            m_size++;
+        }
+
+        void clear() { m_size = 0; }
+
+        unsigned int size()  const { return m_size; }
+        bool         empty() const { return m_size == 0; }
+
+        T&       operator[]( unsigned int i )       { return m_data[i]; }
+        const T& operator[]( unsigned int i ) const { return m_data[i]; }
+
+        T& front() { return m_data[0]; }
+        T& back()  { return m_data[m_size-1]; }
+
+        iterator       begin()       { return m_data; }
+        iterator       end()         { return m_data + m_size; }
+        const_iterator begin() const { return m_data; }
+        const_iterator end()   const { return m_data + m_size; }
+};
+
+} // namespace clarkson93
+} // namespace mpblocks
+
+#endif // MPBLOCKS_CLARKSON93_STATICVECTOR_H_
@@ -30,6 +30,8 @@
 #include <mpblocks/clarkson93.h>
 #include <set>
 #include <queue>
+#include <algorithm>
+#include <functional>
 
 
 namespace   mpblocks {
@@ -118,10 +120,85 @@ class Triangulation:
         typedef std::vector<SimplexRef> SimplexSet;
         typedef std::vector<Ridge>      HorizonSet;
 
+        /// a new wedge simplex keyed by one of its (NDim-2)-faces on the
+        /// horizon, an entry of the open addressed table of alter()
+        struct WedgeEntry
+        {
+            PointRef        face[NDim];     ///< sorted, size of them used
+            unsigned int    size;
+            SimplexRef      S;              ///< the wedge simplex
+            PointRef        v;              ///< vertex of S across the face
+            bool            used;
+            bool            linked;         ///< the other simplex was found
+
+            WedgeEntry():
+                size(0),
+                used(false),
+                linked(false)
+            {}
+
+            bool sameFace( const WedgeEntry& other ) const
+            {
+                return std::equal( face, face + size, other.face );
+            }
+        };
+        typedef std::vector<WedgeEntry> WedgeTable;
+
         // priority queue stuff
         typedef Indexed<Scalar,SimplexRef>  PQ_Key;
         typedef P_Queue<PQ_Key>             WalkQueue;
 
+        /// x-visible region of a point found without touching the simplex
+        /// bitsets, so that several threads may search one triangulation
+        /// at the same time (speculative insertion)
+        struct Region
+        {
+            SimplexSet                      xvh;    ///< x-visible hull simplices
+            HorizonSet                      ridges; ///< horizon ridges
+            WedgeTable                      wedge;  ///< scratch of the wedge linking
+
+            void clear()
+            {
+                xvh   .clear();
+                ridges.clear();
+            }
+        };
+
+        /// per thread scratch of locate_x_visible(), kept across locates so
+        /// that a warm locate does not allocate. A simplex is marked by
+        /// stamping its slot with the epoch of the locate, as the xvWalk and
+        /// xvHull members are for the single threaded walk and fill
+        struct Locator
+        {
+            WalkQueue                       queue;  ///< walk for x-visible search
+            SimplexSet                      stack;  ///< search stack for x-visible hull
+            std::vector<uint32_t>           walked; ///< epoch that last queued each slot
+            std::vector<uint32_t>           hull;   ///< epoch that last found each slot x-visible hull
+            uint32_t                        epoch;
+
+            Locator():
+                epoch(0)
+            {}
+
+            /// start a locate over @p n simplex slots with a fresh stamp
+            void next( std::size_t n )
+            {
+                if( walked.size() < n )
+                {
+                    walked.resize(n,0);
+                    hull  .resize(n,0);
+                }
+                if( ++epoch == 0 )
+                {
+                    std::fill( walked.begin(), walked.end(), 0 );
+                    std::fill( hull  .begin(), hull  .end(), 0 );
+                    epoch = 1;
+                }
+                queue.clear();
+                stack.clear();
+            }
+        };
+
     public:
         // Data Members
         // -----------------------------------------------------------------------
@@ -131,13 +208,16 @@ class Triangulation:
         Deref           m_deref;       ///< dereferences a PointRef or SimplexRef
 
         WalkQueue       m_xv_queue;    ///< walk for x-visible search
-        SimplexSet      m_xv_walked;   ///< set of simplices ever expanded for
-                                       ///  the walk
+        uint32_t        m_epoch;       ///< stamp of the current walk or fill,
+                                       ///  a simplex stamped with it is
+                                       ///  visited, so marks need no clearing
 
         SimplexSet      m_xvh;         ///< set of x-visible hull simplices
         SimplexSet      m_xvh_queue;   ///< search queue for x-visible hull
 
         HorizonSet      m_ridges;      ///< set of horizon ridges
+        WedgeTable      m_wedge;       ///< table of the wedge linking, kept
+                                       ///  across inserts for its capacity
 
         SimplexMgr      m_sMgr;        ///< simplex manager
         Callback        m_callback;    ///< event hooks
@@ -209,6 +289,36 @@ class Triangulation:
         // update each x-visible simplex by adding the point x as the peak
         // vertex, also create new simplices
         void alter_x_visible( const OptLevel<0>&, PointRef x);
+
+        /// find the x-visible region of @p x starting from the origin
+        /// simplex, reading the triangulation only
+        /**
+         *  @param  locator  scratch of the calling thread, never shared
+         *  @return false if x is inside the hull, in which case @p region
+         *          holds no x-visible simplices
+         */
+        bool locate_x_visible( PointRef x, Region& region, Locator& locator );
+
+        /// alter the x-visible region found by locate_x_visible(), using the
+        /// preallocated simplices @p fill (one per horizon ridge) for the
+        /// wedge fill. Regions that share no simplex (including the invisible
+        /// side of their horizon ridges) may be altered concurrently.
+        void alter_region( PointRef x, Region& region, SimplexRef fill );
+
+    private:
+        /// start a walk or fill with a fresh stamp, restamping every simplex
+        /// in the rare case the counter wraps around
+        void nextEpoch();
+
+        /// shared implementation of alter_x_visible() and alter_region(),
+        /// per ridge sets live on the stack and @p wedge is the caller's
+        /// scratch, so a warm caller does not allocate
+        template <class Alloc>
+        void alter( PointRef x, SimplexSet& xvh, HorizonSet& ridges,
+                    WedgeTable& wedge, Alloc alloc );
+
+        typedef StaticVector<PointRef,NDim+1>   VertexBuf;
+        typedef StaticVector<SimplexRef,NDim+1> SimplexBuf;
 };
 
 
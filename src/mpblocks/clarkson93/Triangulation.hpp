@@ -155,6 +155,20 @@ bool Triangulation<Traits>::insert(PointRef x)
 
 
 
+template <class Traits>
+void Triangulation<Traits>::nextEpoch()
+{
+    if( ++m_epoch == 0 )
+    {
+        for( Simplex& S : m_sMgr )
+        {
+            S.xvWalk = 0;
+            S.xvHull = 0;
+        }
+        m_epoch = 1;
+    }
+}
+
 template <class Traits>
 void Triangulation<Traits>::clear()
 {
@@ -162,7 +176,7 @@ void Triangulation<Traits>::clear()
     m_origin      = 0;
     m_sMgr.clear();
     m_xv_queue.clear();
-    m_xv_walked.clear();
+    m_epoch = 0;
     m_xvh.clear();
     m_xvh_queue.clear();
     m_ridges.clear();
@@ -178,16 +192,11 @@ typename Traits::Simplex*
     // turn generic reference into a real reference
     Point& x = m_deref.point(Xref);
 
-    // first clear out our search structures
-    // so the flags get reset, we do this at the beginning so that after the
-    // the update they persist and we can view them for debugging
-    for( SimplexRef Sref : m_xv_walked )
-    {
-        Simplex& S = m_deref.simplex(Sref);
-        setMember( S, simplex::XVISIBLE_WALK ) = false;
-    }
+    //lucas 03/2017
+    // a new stamp marks nothing as walked, instead of clearing the flags
+    // of the previous walk
+    nextEpoch();
     m_xv_queue .clear();
-    m_xv_walked.clear();
 
     /*// if the origin simplex is not visible then start at the neighbor
     // across his base, which must be x-visible
@@ -238,9 +247,8 @@ typename Traits::Simplex*
     Scalar d = foundVisibleHull ? 0 : ( x - m_deref.point(peak(S)) ).squaredNorm();
 
     m_xv_queue.push( PQ_Key( d, Sref ) );
-    m_xv_walked.push_back( Sref );
 
-    setMember( S, simplex::XVISIBLE_WALK   ) = true;
+    S.xvWalk = m_epoch;
 
     // starting at the given simplex, walk in the direction of x until
     // we find an x-visible infinite simplex (i.e. hull facet)
@@ -263,7 +271,7 @@ typename Traits::Simplex*
 
             // if the neighbor is x-visible but has not already been queued or
             // expanded, then add it to the queue
-            if( !isMember( N, simplex::XVISIBLE_WALK ) && isVisible( N, x ) )
+            if( N.xvWalk != m_epoch && isVisible( N, x ) )
             {
                 // if the base facet is x-visible and the simplex is also
                 // infinite then we have found our x-visible hull facet
@@ -278,10 +286,9 @@ typename Traits::Simplex*
                 Scalar d = ( x - m_deref.point(peak(N)) ).squaredNorm();
                 //Scalar d = normalProjection( N, x );
 
-                m_xv_walked.push_back(Nref);
                 m_xv_queue .push( PQ_Key(d,Nref) );
 
-                setMember( N, simplex::XVISIBLE_WALK ) = true;
+                N.xvWalk = m_epoch;
             }
         }
     }
@@ -298,17 +305,7 @@ void Triangulation<Traits>::fill_x_visible(
         const OptLevel<0>&, PointRef Xref, SimplexRef Sref)
 {
     Point& x = m_deref.point(Xref);
-    for( SimplexRef S_ref : m_xvh )
-    {
-        Simplex& S = m_deref.simplex(S_ref);
-        setMember( S, simplex::XV_HULL ) = false;
-    }
-
-    for( Ridge& ridge : m_ridges )
-    {
-        Simplex& S = m_deref.simplex( ridge.Sfill );
-        setMember( S, simplex::HORIZON_FILL ) = false;
-    }
+    nextEpoch();
 
     m_xvh      .clear();
     m_xvh_queue.clear();
@@ -322,7 +319,7 @@ void Triangulation<Traits>::fill_x_visible(
         m_xvh_queue.push_back(Sref);
 
         Simplex& S = m_deref.simplex(Sref);
-        setMember( S, simplex:: XV_HULL ) = true;
+        S.xvHull = m_epoch;
     }
 
     // at each iteration...
@@ -349,9 +346,9 @@ void Triangulation<Traits>::fill_x_visible(
             // if the neighbor is both infinite and x-visible , but has not
             // yet been queued for expansion, then add it to
             // the x-visible hull set, and queue it up for expansion
-            if( xVisible && !isMember(N, simplex::XV_HULL ) )
+            if( xVisible && N.xvHull != m_epoch )
             {
-                setMember( N, simplex::XV_HULL ) = true;
+                N.xvHull = m_epoch;
                 m_xvh_queue.push_back( Nref );
                 m_xvh.push_back( Nref );
             }
@@ -367,11 +364,26 @@ void Triangulation<Traits>::fill_x_visible(
 
 template <class Traits>
 void Triangulation<Traits>::alter_x_visible( const OptLevel<0>&, PointRef Xref)
+{
+    alter( Xref, m_xvh, m_ridges, m_wedge,
+           [this](){ return m_sMgr.create(); } );
+
+    // in order to traverse the hull we need at least one hull simplex and
+    // since all new simplices are hull simlices, we can set one here
+    if( m_ridges.size() > 0 )
+        m_hullSimplex = m_ridges.back().Sfill;
+}
+
+template <class Traits>
+template <class Alloc>
+void Triangulation<Traits>::alter( PointRef Xref, SimplexSet& xvh,
+                                   HorizonSet& ridges, WedgeTable& wedge,
+                                   Alloc alloc )
 {
     // first we go through all the x-visible simplices, and replace their
     // peak vertex (the ficitious anti-origin) with the new point x, and then
     // notify any hooks that the simplex was removed from the hull
-    for(SimplexRef Sref : m_xvh)
+    for(SimplexRef Sref : xvh)
     {
         Simplex& S = m_deref.simplex(Sref);
         setPeak(S) = Xref;
@@ -381,16 +393,12 @@ void Triangulation<Traits>::alter_x_visible( const OptLevel<0>&, PointRef Xref)
     }
 
     // now for each horizon ridge we have to construct a new simplex
-    for( Ridge& ridge : m_ridges )
+    for( Ridge& ridge : ridges )
     {
         // allocate a new simplex and add it to the list
-        SimplexRef Snew = m_sMgr.create();
+        SimplexRef Snew = alloc();
         ridge.Sfill = Snew;
 
-        // in order to traverse the hull we need at least one hull simplex and
-        // since all new simplices are hull simlices, we can set one here
-        m_hullSimplex = Snew;
-
         // In the parlance of Clarkson, we have two simplices V and N
         // note that V is ridge->Svis and N is ridge->Sinvis
         // V was an infinite simplex and became
@@ -412,8 +420,7 @@ void Triangulation<Traits>::alter_x_visible( const OptLevel<0>&, PointRef Xref)
 
         // split the vertex set of V and N into those that are only in V,
         // those that are only in N, and those that are common
-        std::vector<PointRef> vRidge, vV, vN;
-        vRidge.reserve(NDim-1);
+        VertexBuf vRidge, vV, vN;
         vsetSplit( V, N,
                     std::back_inserter(vV),
                     std::back_inserter(vN),
@@ -445,9 +452,6 @@ void Triangulation<Traits>::alter_x_visible( const OptLevel<0>&, PointRef Xref)
         // vertices now
         finish( S );
 
-        // mark this simplex as a member of the horizon wedge fill
-        setMember( S, simplex::HORIZON_FILL ) = true;
-
         // we'll need to use the half-space inequality at some point but
         // we can't calcualte it normally b/c one of the vertices isn't at
         // a real location, so we calculate it to be coincident to the base
@@ -457,121 +461,180 @@ void Triangulation<Traits>::alter_x_visible( const OptLevel<0>&, PointRef Xref)
         orientBase( S, m_deref.point(vV[0]), OUTSIDE );
     }
 
+    //lucas 03/2017
     // ok now that all the new simplices have been added, we need to go
-    // and assign neighbors to these new simplicies
-    for( Ridge& ridge : m_ridges )
+    // and assign neighbors to these new simplicies. The facet of a fill
+    // simplex S across a ridge vertex v holds x, the anti-origin and the
+    // (NDim-2)-face f = ridge \ {v}. Every such face of the horizon bounds
+    // exactly two horizon ridges, so exactly two fill simplices contain it,
+    // and they are neighbors. Instead of walking around f, each fill simplex
+    // is keyed by its faces in an open addressed table and pairs are linked
+    // when the second of them arrives.
+    std::size_t bits = 1;
+    while( ((std::size_t)1 << bits) < 2 * ridges.size() * (NDim-1) )
+        bits++;
+    const std::size_t mask = ((std::size_t)1 << bits) - 1;
+    wedge.assign( mask + 1, WedgeEntry() );
+
+    for( Ridge& ridge : ridges )
     {
         Simplex& S = m_deref.simplex( ridge.Sfill );
-        Simplex& V = m_deref.simplex( ridge.Svis  );
-        Simplex& N = m_deref.simplex( ridge.Sinvis  );
-
-        // let x be a vertex of S for which a neighbor has not been assigned,
-        // then the facet f across from x is a set of NDim vertices. Let
-        // f_N be the (NDim-1) vertices f \ {antiOrigin}. Well then V must
-        // share that facet. Furthermore, if we step into V then V only has
-        // one neighbor other than S which shares that facet. Each simplex
-        // that shares this facet has exactly two neighbors sharing that
-        // facet. The missing neighbor of S also shares that facet. Thus we
-        // walk through the simplices S->V->...->N_x until we find N_x which
-        // will be the first HORIZON_FILL simplex on that path.
-
-        // so start by building the horizon ridge wedge facet as a set of
-        // vertices
-        std::set<PointRef> ridgeFacet;
-        vsetIntersection( V, N,
-                std::inserter( ridgeFacet, ridgeFacet.begin() ) );
+
+        // the ridge vertices, sorted since the vertices of S are
+        VertexBuf ridgeFacet;
+        for( unsigned int i=0; i < NDim+1; i++ )
+            if( vertex(S,i) != Xref && vertex(S,i) != m_antiOrigin )
+                ridgeFacet.push_back( vertex(S,i) );
         assert( ridgeFacet.size() == NDim-1 );
 
-        // now for each vertex in that set, we need to find the neighbor
-        // across from that vertex
         for( PointRef v : ridgeFacet )
         {
-            // so build the edge which is the ridge facet without that
-            // particular vertex
-            std::vector<PointRef> edge;
-            edge.reserve(NDim-1);
-            std::copy_if( ridgeFacet.begin(), ridgeFacet.end(),
-                            std::back_inserter(edge),
-                            [v]( PointRef q ){ return q != v; } );
-            edge.push_back( Xref );
-            assert( edge.size() == NDim-1 );
-
-            // now start our walk with S and V
-            setMember( S, simplex::S_WALK ) = true;
-            setMember( V, simplex::S_WALK ) = true;
-
-            // create a search queue (will only ever hold 2 elements)
-            std::vector<SimplexRef> queue;
-            std::vector<SimplexRef> expanded;
-            std::vector<SimplexRef> neighborhood;
-            queue.reserve(2);
-            queue.push_back( ridge.Svis );
-            expanded.push_back( ridge.Svis );
-            expanded.push_back( ridge.Sfill );
-
-            // this is where we'll put the found neighbor
-            SimplexRef Nfound;
-            bool       foundNeighbor = false;
-
-            // while the queue is not empty
-            while( queue.size() > 0 && !foundNeighbor )
+            WedgeEntry entry;
+            std::size_t hash = 0;
+            for( PointRef q : ridgeFacet )
+            {
+                if( q == v )
+                    continue;
+                entry.face[entry.size++] = q;
+                hash = (hash ^ std::hash<PointRef>()(q)) * 0x9e3779b97f4a7c15ull;
+            }
+
+            // fibonacci hashing, the top bits are the well mixed ones
+            std::size_t j = (hash >> (8 * sizeof(std::size_t) - bits)) & mask;
+            while( wedge[j].used && !wedge[j].sameFace(entry) )
+                j = (j+1) & mask;
+
+            if( wedge[j].used )
             {
-                // pop one element off the queue
-                SimplexRef Sc_ref = queue.back();
-                queue.pop_back();
-                Simplex& Sc = m_deref.simplex(Sc_ref);
-
-                // find all the neighbors that share the facet
-                neighborhood.clear();
-                neighborSharing( Sc, edge.begin(), edge.end(),
-                                    std::back_inserter(neighborhood) );
-                assert( neighborhood.size() == 2 );
-
-                // get the one neighbor which isn't already in S_WALK
-                for( SimplexRef Nref : neighborhood )
+                assert( !wedge[j].linked );
+                wedge[j].linked = true;
+                setNeighborAcross( S,v ) = wedge[j].S;
+                setNeighborAcross( m_deref.simplex(wedge[j].S), wedge[j].v )
+                    = ridge.Sfill;
+            }
+            else
+            {
+                entry.used = true;
+                entry.S    = ridge.Sfill;
+                entry.v    = v;
+                wedge[j]   = entry;
+            }
+        }
+    }
+
+    // now that neighbors have been assigned we can inform any listeners
+    for( Ridge& ridge : ridges )
+        m_callback.hullFaceAdded( ridge.Sfill );
+}
+
+
+template <class Traits>
+bool Triangulation<Traits>::locate_x_visible( PointRef Xref, Region& region,
+                                              Locator& locator )
+{
+    // this follows find_x_visible() and fill_x_visible(), but all of the
+    // bookkeeping lives in the region and the locator instead of the
+    // simplices, so the triangulation is only read
+    Point& x = m_deref.point(Xref);
+    region.clear();
+
+    //lucas 03/2017
+    // slots are the simplex offsets in the manager, which does not grow
+    // while threads are locating
+    Simplex* slot0 = m_sMgr.data();
+    locator.next( m_sMgr.capacity() );
+    const uint32_t epoch = locator.epoch;
+
+    SimplexRef Sref = m_origin;
+    {
+        Simplex& S = m_deref.simplex(Sref);
+        auto Nref = neighborAcross(S,peak(S));
+        Simplex& N = m_deref.simplex(Nref);
+
+        if( isVisible(N,x) )
+            Sref = Nref;
+    }
+
+    Simplex& S = m_deref.simplex(Sref);
+    bool foundVisibleHull = isInfinite( S, m_antiOrigin );
+
+    Scalar d = foundVisibleHull ? 0 : ( x - m_deref.point(peak(S)) ).squaredNorm();
+    locator.queue.push( PQ_Key( d, Sref ) );
+    locator.walked[ Sref - slot0 ] = epoch;
+
+    while( locator.queue.size() > 0 && !foundVisibleHull )
+    {
+        SimplexRef pop_ref = locator.queue.pop().val;
+        Simplex& pop = m_deref.simplex(pop_ref);
+        SimplexRef parent = neighborAcross( pop, peak(pop) );
+
+        for( SimplexRef Nref : neighborhood(pop) )
+        {
+            if( Nref == parent )
+                continue;
+
+            Simplex& N = m_deref.simplex(Nref);
+            if( locator.walked[ Nref - slot0 ] != epoch && isVisible( N, x ) )
+            {
+                if( isInfinite(N, m_antiOrigin) )
                 {
-                    Simplex& N = m_deref.simplex(Nref);
-
-                    // if it's not the one we came from
-                    if( !isMember(N,simplex::S_WALK) )
-                    {
-                        // if N is in HORIZON_FILL then this is the neighbor
-                        // we are looking for
-                        if( isMember(N,simplex::HORIZON_FILL) )
-                        {
-                            Nfound        = Nref;
-                            foundNeighbor = true;
-                            break;
-                        }
-
-                        queue.push_back(Nref);
-                        expanded.push_back(Nref);
-                        setMember( N, simplex::S_WALK ) = true;
-                    }
+                    Sref             = Nref;
+                    foundVisibleHull = true;
+                    break;
                 }
 
-                // sanity check
-                assert( queue.size() < 2 );
+                Scalar d = ( x - m_deref.point(peak(N)) ).squaredNorm();
+                locator.walked[ Nref - slot0 ] = epoch;
+                locator.queue .push( PQ_Key(d,Nref) );
             }
+        }
+    }
 
-            for( SimplexRef Ss : expanded )
-                setMember( m_deref.simplex(Ss), simplex::S_WALK ) = false;
+    if( !isMember( m_deref.simplex(Sref), simplex::HULL ) )
+        return false;
 
-            // sanity check
-            assert( foundNeighbor );
-            assert( Nfound != ridge.Sfill );
-
-            // set the other guy as our neighbor, we dont do the inverse
-            // setting of the neighbor as it will happen when Nfound is
-            // processedlater, note that this incurs a doubling of the
-            // amount of S_WALKing that we do and can possibly be optimized
-            setNeighborAcross( S,v ) = Nfound;
+    // expand to the whole x-visible hull and collect its horizon
+    region.xvh   .push_back(Sref);
+    locator.stack.push_back(Sref);
+    locator.hull[ Sref - slot0 ] = epoch;
+
+    while( locator.stack.size() > 0 )
+    {
+        SimplexRef Sref = locator.stack.back();
+        Simplex& S      = m_deref.simplex(Sref);
+        locator.stack.pop_back();
+
+        for( SimplexRef Nref : neighborhood(S) )
+        {
+            if( Nref == peakNeighbor(S) )
+                continue;
+
+            Simplex& N = m_deref.simplex(Nref);
+            bool xVisible = isVisible(N,x);
+            assert( isInfinite(N,m_antiOrigin) );
+
+            if( xVisible && locator.hull[ Nref - slot0 ] != epoch )
+            {
+                locator.hull[ Nref - slot0 ] = epoch;
+                locator.stack.push_back( Nref );
+                region.xvh   .push_back( Nref );
+            }
+
+            if( ! xVisible )
+                region.ridges.emplace_back(Sref,Nref);
         }
     }
 
-    // now that neighbors have been assigned we can inform any listeners
-    for( Ridge& ridge : m_ridges )
-        m_callback.hullFaceAdded( ridge.Sfill );
+    return true;
+}
+
+
+template <class Traits>
+void Triangulation<Traits>::alter_region( PointRef Xref, Region& region,
+                                          SimplexRef fill )
+{
+    alter( Xref, region.xvh, region.ridges, region.wedge,
+           [&fill](){ return fill++; } );
 }
 
 
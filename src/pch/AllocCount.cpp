@@ -0,0 +1,133 @@
+//
+//  AllocCount.cpp
+//
+//	by Jiahuan.Liu
+//	jiahaun.liu@outlook.com
+//
+//  03/22/2017
+//
+
+#include <atomic>
+#include <new>
+#include <stdlib.h>
+
+#include "AllocCount.h"
+
+static std::atomic<bool> s_counting(false);
+static std::atomic<long> s_allocs(0);
+
+void AllocCount::start()
+{
+	s_allocs.store(0, std::memory_order_relaxed);
+	s_counting.store(true, std::memory_order_relaxed);
+}
+
+long AllocCount::stop()
+{
+	s_counting.store(false, std::memory_order_relaxed);
+	return s_allocs.load(std::memory_order_relaxed);
+}
+
+static void* allocate(size_t size)
+{
+	if (s_counting.load(std::memory_order_relaxed))
+	{
+		s_allocs.fetch_add(1, std::memory_order_relaxed);
+	}
+	return malloc(size ? size : 1);
+}
+
+void* operator new(size_t size)
+{
+	if (void* p = allocate(size)) return p;
+	throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+	return allocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+	return allocate(size);
+}
+
+void operator delete(void* p) noexcept
+{
+	free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+	free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept
+{
+	free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept
+{
+	free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+	free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept
+{
+	free(p);
+}
+
+#ifdef __cpp_aligned_new
+//over-aligned types only exist from C++17, posix_memalign memory is freed by free
+static void* allocateAligned(size_t size, std::align_val_t align)
+{
+	if (s_counting.load(std::memory_order_relaxed))
+	{
+		s_allocs.fetch_add(1, std::memory_order_relaxed);
+	}
+	void* p = nullptr;
+	return posix_memalign(&p, (size_t)align, size ? size : 1) ? nullptr : p;
+}
+
+void* operator new(size_t size, std::align_val_t align)
+{
+	if (void* p = allocateAligned(size, align)) return p;
+	throw std::bad_alloc();
+}
+
+void* operator new[](size_t size, std::align_val_t align)
+{
+	return operator new(size, align);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept
+{
+	free(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept
+{
+	free(p);
+}
+
+void operator delete(void* p, size_t, std::align_val_t) noexcept
+{
+	free(p);
+}
+
+void operator delete[](void* p, size_t, std::align_val_t) noexcept
+{
+	free(p);
+}
+#endif
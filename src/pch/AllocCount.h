@@ -0,0 +1,32 @@
+//
+//  AllocCount.h
+//
+//	@brief: count of the heap allocations of the binary, so a test can
+//			assert that a code path does not allocate; global operator new
+//			is replaced in AllocCount.cpp and counts only while counting
+//			is on, so timed code pays one relaxed load per allocation
+//
+//	by Jiahuan.Liu
+//	jiahaun.liu@outlook.com
+//
+//  03/22/2017
+//
+
+#ifndef _ALLOCCOUNT_H
+#define _ALLOCCOUNT_H
+
+class AllocCount
+{
+public:
+	//
+	// @brief: start counting from 0
+	//
+	static void start();
+
+	//
+	// @return: allocations since start
+	//
+	static long stop();
+};
+
+#endif
@@ -0,0 +1,164 @@
+//
+//  Brio.h
+//
+//	@brief: biased randomized insertion order of points of any
+//			dimensionality, rounds of random samples growing geometrically,
+//			each round sorted along a Morton curve
+//
+//	by Jiahuan.Liu
+//	jiahaun.liu@outlook.com
+//
+//  03/22/2017
+//
+
+#ifndef _BRIO_H
+#define _BRIO_H
+
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <stdint.h>
+#include <omp.h>
+
+#include "Points.h"
+#include "ParalSort.h"
+
+const int BRIO_MIN_ROUND = 64; //the first round takes every point left below this
+
+template <typename Tr>
+class BrioT
+{
+public:
+	static const int NDim = Tr::NDim;
+	static const int BITS = 63 / NDim; //Morton bits per coordinate
+	using val_t = double;
+	using code_t = uint64_t;
+public:
+	//
+	// @brief: points of [beg, end) in biased randomized insertion order
+	// @param: seed: of the random sample, the order is deterministic for one
+	//
+	template <typename Itr, typename GetRef,
+		typename R = std::vector<typename std::iterator_traits<Itr>::value_type> >
+	static R sort(Itr beg, Itr end, GetRef getRef, int thrNum = 1, unsigned seed = 0);
+
+private:
+	//
+	// @param: coordAt: coordAt(i, d) is coordinate d of point i
+	// @return: indices of the points in insertion order
+	//
+	template <typename CoordAt>
+	static std::vector<int> _order(int size, CoordAt coordAt, int thrNum, unsigned seed);
+
+	//
+	// @brief: interleave the bits of the quantized coordinates q
+	//
+	static code_t _morton(const code_t* q);
+};
+
+template <typename Tr>
+template <typename Itr, typename GetRef,
+	typename R>
+R BrioT<Tr>::sort(Itr beg, Itr end, GetRef getRef, int thrNum, unsigned seed)
+{
+	const int size = end - beg;
+
+	std::vector<int> order = _order(size,
+		[&](int i, int d){return (*getRef(beg + i))[d];}, thrNum, seed);
+
+	R res;
+	res.reserve(size);
+	for (int idx : order)
+	{
+		res.push_back(*(beg + idx));
+	}
+	return res;
+}
+
+template <typename Tr>
+template <typename CoordAt>
+std::vector<int> BrioT<Tr>::_order(int size, CoordAt coordAt, int thrNum, unsigned seed)
+{
+	std::vector<int> res(size);
+	for (int i = 0; i < size; ++i)
+	{
+		res[i] = i;
+	}
+	std::shuffle(res.begin(), res.end(), std::mt19937(seed));
+
+	//bounding box of the quantization
+	val_t lo[NDim], hi[NDim];
+	for (int d = 0; d < NDim; ++d)
+	{
+		lo[d] = size ? coordAt(0, d) : 0;
+		hi[d] = lo[d];
+	}
+	for (int i = 1; i < size; ++i)
+	{
+		for (int d = 0; d < NDim; ++d)
+		{
+			lo[d] = std::min(lo[d], (val_t)coordAt(i, d));
+			hi[d] = std::max(hi[d], (val_t)coordAt(i, d));
+		}
+	}
+
+	//codes in shuffled order, so each round is a contiguous range
+	const val_t cells = (val_t)(((code_t)1 << BITS) - 1);
+	std::vector<std::pair<code_t, int>> codes(size);
+
+	#pragma omp parallel for schedule(static) shared(codes, res, coordAt, lo, hi) num_threads(thrNum)
+	for (int i = 0; i < size; ++i)
+	{
+		code_t q[NDim];
+		for (int d = 0; d < NDim; ++d)
+		{
+			val_t extent = hi[d] - lo[d];
+			q[d] = extent > 0 ? (code_t)((coordAt(res[i], d) - lo[d]) / extent * cells) : 0;
+		}
+		codes[i] = std::make_pair(_morton(q), res[i]);
+	}
+
+	//rounds [n / 2, n), [n / 4, n / 2), ... until BRIO_MIN_ROUND, every
+	//other round runs backwards along the curve so consecutive rounds meet
+	std::vector<int> bounds(1, size);
+	while (bounds.back() > BRIO_MIN_ROUND)
+	{
+		bounds.push_back(bounds.back() / 2);
+	}
+	bounds.push_back(0);
+	std::reverse(bounds.begin(), bounds.end());
+
+	for (int r = 0; r + 1 < bounds.size(); ++r)
+	{
+		auto first = codes.begin() + bounds[r], last = codes.begin() + bounds[r + 1];
+		ParalSort::mergesort(first, last, thrNum);
+		if (r % 2) std::reverse(first, last);
+	}
+
+	for (int i = 0; i < size; ++i)
+	{
+		res[i] = codes[i].second;
+	}
+	return res;
+}
+
+template <typename Tr>
+typename BrioT<Tr>::code_t BrioT<Tr>::_morton(const code_t* q)
+{
+	code_t code = 0;
+	for (int b = BITS - 1; b >= 0; --b)
+	{
+		for (int d = 0; d < NDim; ++d)
+		{
+			code = code << 1 | (q[d] >> b & 1);
+		}
+	}
+	return code;
+}
+
+template <typename Tr> const int BrioT<Tr>::NDim;
+template <typename Tr> const int BrioT<Tr>::BITS;
+
+typedef BrioT<Traits> Brio;
+
+#endif
@@ -11,16 +11,24 @@
 #include <stdio.h>
 #include <time.h>
 #include <math.h>
+#include <limits.h>
+#include <atomic>
+#include <algorithm>
+#include <random>
+#include <omp.h>
 
 #include "Hull.h"
+#include "Polygon.h"
 
-Hull::Hull(int n) :_initialized(false)
+template <typename Tr>
+HullT<Tr>::HullT(int n) :_initialized(false), _reseeding(false), _overflow(false), _localWalk(false), _walkRand(1), _walkFrom(nullptr)
 {
 	_hull.m_antiOrigin = 0;
 	_hull.m_sMgr.reserve((NDim + 1) * n);
 }
 
-bool Hull::insert(PointRef p)
+template <typename Tr>
+bool HullT<Tr>::insert(PointRef p)
 {
 	bool isPeak = true;
 
@@ -29,46 +37,446 @@ bool Hull::insert(PointRef p)
 		if (_origin.insert(p))
 		{
 			_hull.init(_origin.begin(), _origin.end(), 
-				[](OriginSimplex::iterator itr){return *itr;});
+				[](typename OriginSimplex::iterator itr){return *itr;});
 			_initialized = true;
+
+			//a reseed would clear the origin simplex
+			PointRefVec deferred = _origin.deferred();
+			for (PointRef q : deferred)
+			{
+				insert(q);
+			}
 		}
 	}
-	else
-	{
-		isPeak = _hull.insert(p);
+	else if (!_overflow)
+	{//as Triangulation::insert, but a point adding more simplices than fit reseeds first
+		Simplex* S = _localWalk ? _walkNear(p) : nullptr;
+		if (!S) S = _hull.find_x_visible(p, _hull.m_origin);
+		if (!_hull.isMember(*S, clarkson93::simplex::HULL)) return false;
+
+		_hull.fill_x_visible(Triangulation_t::s_optLvl, p, S);
+		if (!_room(_hull.m_ridges.size()))
+		{
+			//the simplices cannot grow under a live triangulation, so a
+			//reseed that overflows itself starts over with more of them
+			if (_reseeding)
+			{
+				_overflow = true;
+				return false;
+			}
+			reseed((_hull.m_ridges.size() + NDim) / (NDim + 1));
+			return insert(p);
+		}
+		_hull.alter_x_visible(Triangulation_t::s_optLvl, p);
 	}
 
 	return isPeak;
 }
 
-void Hull::insert(PointRefVec& pointRefs)
+template <typename Tr>
+void HullT<Tr>::insert(PointRefVec& pointRefs)
 {
-	for (auto& p : pointRefs)
+	const int size = pointRefs.size();
+	int first = 0;
+	for (; first < size && !_initialized; ++first)
 	{
-		insert(p);
+		insert(pointRefs[first]);
+	}
+
+	for (; first < size; first += FILTER_BLOCK)
+	{
+		_insertBlock(pointRefs, first, std::min(first + FILTER_BLOCK, size), nullptr);
 	}
 }
 
-void Hull::insert(PointVec& points)
+template <typename Tr>
+void HullT<Tr>::insert(PointRefVec& pointRefs, const typename PointSoA::View& view)
 {
+	const int size = pointRefs.size();
+	int first = 0;
+	for (; first < size && !_initialized; ++first)
+	{
+		insert(pointRefs[first]);
+	}
+
+	for (; first < size; first += FILTER_BLOCK)
+	{
+		const int last = std::min(first + FILTER_BLOCK, size);
+		_insertBlock(pointRefs, first, last, view.sub(first, last).coords());
+	}
+}
+
+template <typename Tr>
+void HullT<Tr>::insert(PointVec& points)
+{
+	PointRefVec refs;
+	refs.reserve(points.size());
 	for (auto& p : points)
 	{
-		insert(&p);
+		refs.push_back(&p);
+	}
+	insert(refs);
+}
+
+template <typename Tr>
+void HullT<Tr>::_insertBlock(PointRefVec& refs, int first, int last, const Val_t* const* coords)
+{
+	getFacets(_facets);
+	if (_facets.size() > FILTER_FACETS)
+	{
+		for (int i = first; i < last; ++i) insert(refs[i]);
+		return;
+	}
+
+	_filter(refs, first, last, coords);
+	for (int i = 0; i < last - first; ++i)
+	{
+		if (_mask[i / 64] >> (i % 64) & 1) insert(refs[first + i]);
+	}
+}
+
+template <typename Tr>
+void HullT<Tr>::_dropInside(PointRefVec& refs, int first)
+{
+	const int last = refs.size();
+	_filter(refs, first, last, nullptr);
+
+	int kept = first;
+	for (int i = 0; i < last - first; ++i)
+	{
+		if (_mask[i / 64] >> (i % 64) & 1) refs[kept++] = refs[first + i];
 	}
+	refs.resize(kept);
 }
 
-void Hull::clear()
+template <typename Tr>
+void HullT<Tr>::_filter(const PointRefVec& refs, int first, int last, const Val_t* const* coords)
+{
+	const int count = last - first;
+	const Val_t* gathered[NDim];
+	if (!coords)
+	{
+		for (int d = 0; d < NDim; ++d)
+		{
+			_coords[d].resize(count);
+			for (int i = 0; i < count; ++i)
+			{
+				_coords[d][i] = (*refs[first + i])[d];
+			}
+			gathered[d] = _coords[d].data();
+		}
+		coords = gathered;
+	}
+	_mask.resize((count + 63) / 64);
+
+	Visibility::outside(coords, count, _facets, _mask.data());
+}
+
+template <typename Tr>
+typename HullT<Tr>::Simplex* HullT<Tr>::_walkNear(PointRef p)
+{
+	//finite simplices tile the hull and are never freed until clear, so a
+	//walk across facets p lies beyond ends in the simplex holding p, or
+	//leaves the hull through a facet p sees; facets are tried from a random
+	//one, as a fixed order may cycle
+	Simplex* S = _walkFrom ? _walkFrom : _hull.m_origin;
+	for (int step = 0; step < WALK_STEPS; ++step)
+	{
+		_walkRand ^= _walkRand << 13;
+		_walkRand ^= _walkRand >> 17;
+		_walkRand ^= _walkRand << 5;
+
+		Simplex* next = nullptr;
+		for (int k = 0, i = _walkRand % (NDim + 1); k < NDim + 1 && !next; ++k, i = (i + 1) % (NDim + 1))
+		{
+			if (_hull.facetSide(*S, i, *p) < 0) next = _hull.neighbor(*S, i);
+		}
+		_walkFrom = S;
+		if (!next) return S;
+		if (_hull.isMember(*next, clarkson93::simplex::HULL)) return next;
+		S = next;
+	}
+	return nullptr;
+}
+
+template <typename Tr>
+void HullT<Tr>::insertSpeculative(PointRefVec& pointRefs, int thrNum, int batch)
+{
+	auto itr = pointRefs.begin();
+	for (; itr != pointRefs.end() && !_initialized; ++itr)
+	{
+		insert(*itr);
+	}
+	if (itr == pointRefs.end()) return;
+
+	//owner of each simplex in the current round, lowest batch index wins
+	Simplex* base = nullptr;
+	std::vector<std::atomic<int>> owner;
+	auto rebase = [this, &owner, &base]()
+	{
+		_hull.m_ridges.clear();
+
+		base = _hull.m_sMgr.data();
+		owner = std::vector<std::atomic<int>>(_hull.m_sMgr.capacity());
+		for (auto& o : owner)
+		{
+			o.store(INT_MAX, std::memory_order_relaxed);
+		}
+	};
+	rebase();
+
+	auto reserve = [&owner, &base](Simplex* S, int i)
+	{
+		std::atomic<int>& o = owner[S - base];
+		int curr = o.load(std::memory_order_relaxed);
+		while (i < curr && !o.compare_exchange_weak(curr, i)) {}
+	};
+	auto owns = [&owner, &base](Simplex* S, int i)
+	{
+		return owner[S - base].load(std::memory_order_relaxed) == i;
+	};
+	auto release = [&owner, &base](Simplex* S)
+	{
+		owner[S - base].store(INT_MAX, std::memory_order_relaxed);
+	};
+
+	std::vector<Region>& regions = _regions;
+	if (regions.size() < batch) regions.resize(batch);
+	if (_locators.size() < thrNum) _locators.resize(thrNum);
+	std::vector<int> outside(batch), won(batch), offset(batch);
+	PointRefVec curr;
+	curr.reserve(batch);
+
+	while (itr != pointRefs.end() || !curr.empty())
+	{
+		//losers of last round stay in front so they win eventually, new
+		//points seeing no facet of the hull are dropped as in _insertBlock;
+		//the survivors all see one of few facets, so a round of more of
+		//them than facets mostly conflicts and relocates next round
+		getFacets(_facets);
+		const bool filter = _facets.size() <= FILTER_FACETS;
+		const int round = filter ? std::min(batch, std::max(thrNum, _facets.size())) : batch;
+		while ((int)curr.size() < round && itr != pointRefs.end())
+		{
+			const int first = curr.size();
+			while ((int)curr.size() < round && itr != pointRefs.end())
+			{
+				curr.push_back(*itr++);
+			}
+			if (filter) _dropInside(curr, first);
+		}
+		const int cnt = curr.size();
+
+		#pragma omp parallel for schedule(dynamic, 1) num_threads(thrNum)
+		for (int i = 0; i < cnt; ++i)
+		{
+			Region& r = regions[i];
+			outside[i] = _hull.locate_x_visible(curr[i], r, _locators[omp_get_thread_num()]);
+			if (!outside[i]) continue;
+			for (Simplex* S : r.xvh) reserve(S, i);
+			for (auto& ridge : r.ridges) reserve(ridge.Sinvis, i);
+		}
+
+		#pragma omp parallel for schedule(static) num_threads(thrNum)
+		for (int i = 0; i < cnt; ++i)
+		{
+			Region& r = regions[i];
+			bool w = outside[i];
+			for (Simplex* S : r.xvh) w = w && owns(S, i);
+			for (auto& ridge : r.ridges) w = w && owns(ridge.Sinvis, i);
+			won[i] = w;
+		}
+
+		int total = 0;
+		for (int i = 0; i < cnt; ++i)
+		{
+			offset[i] = total;
+			if (won[i]) total += regions[i].ridges.size();
+		}
+
+		if (!_room(total))
+		{//regions point into the old simplices, so the whole round retries
+			reseed((total + NDim) / (NDim + 1));
+			rebase();
+			continue;
+		}
+
+		if (total > 0)
+		{
+			Simplex* fill = _hull.m_sMgr.create(total);
+
+			//winners' regions are disjoint, so they can be altered together
+			#pragma omp parallel for schedule(dynamic, 1) num_threads(thrNum)
+			for (int i = 0; i < cnt; ++i)
+			{
+				if (won[i]) _hull.alter_region(curr[i], regions[i], fill + offset[i]);
+			}
+			_hull.m_hullSimplex = fill + total - 1;
+		}
+
+		int retry = 0;
+		for (int i = 0; i < cnt; ++i)
+		{
+			if (!outside[i]) continue;
+			for (Simplex* S : regions[i].xvh) release(S);
+			for (auto& ridge : regions[i].ridges) release(ridge.Sinvis);
+			if (!won[i]) curr[retry++] = curr[i];
+		}
+		curr.resize(retry);
+	}
+}
+
+template <typename Tr>
+void HullT<Tr>::insertConflict(PointRefVec& pointRefs)
+{
+	const int size = pointRefs.size();
+	int first = 0;
+	for (; first < size && !_initialized; ++first)
+	{
+		insert(pointRefs[first]);
+	}
+	if (first == size) return;
+
+	//a random order keeps the expected O(n log n) bound for any input order
+	PointRefVec refs(pointRefs.begin() + first, pointRefs.end());
+	std::shuffle(refs.begin(), refs.end(), std::mt19937(0));
+	const int num = refs.size();
+
+	//the hull is only the origin simplex and deferred points, so the
+	//initial walks are short
+	_conflict.assign(num, nullptr);
+	_next.assign(num, -1);
+	_head.assign(_hull.m_sMgr.capacity(), -1);
+	for (int i = 0; i < num; ++i)
+	{
+		_locate(refs, i);
+	}
+
+	for (int i = 0; i < num; ++i)
+	{
+		Simplex* S = _conflict[i];
+		if (!S) continue;
+
+		_hull.fill_x_visible(Triangulation_t::s_optLvl, refs[i], S);
+		if (!_room(_hull.m_ridges.size()))
+		{//the reseed replaces every facet, so pending points walk once more
+			reseed((_hull.m_ridges.size() + NDim) / (NDim + 1));
+			_head.assign(_hull.m_sMgr.capacity(), -1);
+			for (int j = i; j < num; ++j)
+			{
+				if (_conflict[j]) _locate(refs, j);
+			}
+			--i;
+			continue;
+		}
+		_hull.alter_x_visible(Triangulation_t::s_optLvl, refs[i]);
+		_conflict[i] = nullptr;
+
+		//a point seeing a replaced facet is either inside the new hull or
+		//sees one of the new facets
+		for (Simplex* R : _hull.m_xvh)
+		{
+			int& head = _head[_index(R)];
+			for (int j = head, next; j != -1; j = next)
+			{
+				next = _next[j];
+				_conflict[j] = nullptr;
+				if (j == i) continue;
+
+				for (auto& ridge : _hull.m_ridges)
+				{
+					if (_hull.isVisible(*ridge.Sfill, *refs[j]))
+					{
+						_attach(j, ridge.Sfill);
+						break;
+					}
+				}
+			}
+			head = -1;
+		}
+	}
+}
+
+template <typename Tr>
+void HullT<Tr>::_attach(int i, Simplex* S)
+{
+	int& head = _head[_index(S)];
+	_conflict[i] = S;
+	_next[i] = head;
+	head = i;
+}
+
+template <typename Tr>
+void HullT<Tr>::_locate(const PointRefVec& refs, int i)
+{
+	Simplex* S = _hull.find_x_visible(refs[i], _hull.m_origin);
+	_conflict[i] = nullptr;
+	if (_hull.isMember(*S, clarkson93::simplex::HULL)) _attach(i, S);
+}
+
+template <typename Tr>
+void HullT<Tr>::clear()
 {
-	_hull.m_xv_walked.clear();
 	_hull.m_xvh.clear();
 	_hull.m_ridges.clear();
 	_hull.clear();
+	_origin.clear();
+	_initialized = false;
+	_walkFrom = nullptr;
 }
 
-PointRefVec Hull::getPeaks()
+template <typename Tr>
+void HullT<Tr>::reset(int n)
+{
+	clear();
+	if (_hull.m_sMgr.capacity() < (size_t)(NDim + 1) * n)
+	{
+		_hull.m_sMgr.reserve((NDim + 1) * n);
+	}
+}
+
+template <typename Tr>
+bool HullT<Tr>::_room(size_t n) const
+{
+	return _hull.m_sMgr.capacity() - _hull.m_sMgr.size() >= n;
+}
+
+template <typename Tr>
+bool HullT<Tr>::fits(int n) const
+{
+	return _hull.m_sMgr.capacity() - _hull.m_sMgr.size() >= (size_t)NDim * n + NDim + 1;
+}
+
+template <typename Tr>
+void HullT<Tr>::reseed(int n)
+{
+	auto peaks = getPeaks();
+
+	//no simplex is alive after clear, so reallocating is safe; when the
+	//peaks alone fill the simplices, e.g. all points on a sphere, the
+	//rebuild overflows and is retried with twice as many
+	size_t need = (NDim + 1) * (peaks.size() + n);
+	for (_overflow = true; _overflow; need *= 2)
+	{
+		clear();
+		_overflow = false;
+		if (_hull.m_sMgr.capacity() < need)
+		{
+			_hull.m_sMgr.reserve(2 * need);
+		}
+
+		_reseeding = true;
+		insert(peaks);
+		_reseeding = false;
+		_overflow = _overflow || !_room((NDim + 1) * n);
+	}
+}
+
+template <typename Tr>
+typename HullT<Tr>::PointRefVec HullT<Tr>::getPeaks()
 {
 	PointRefVec peaks;
-	PointHashSet peakSet;
+	std::unordered_set<Point> peakSet;
 
 	if (_initialized)
 	{
@@ -88,47 +496,196 @@ PointRefVec Hull::getPeaks()
 		}
 	}
 	else
-	{
+	{//every point is a candidate while the hull is flat
 		for (auto ref : _origin)
 		{
 			peaks.push_back(ref);
 		}
+		for (auto ref : _origin.deferred())
+		{
+			peaks.push_back(ref);
+		}
 	}
 	
-	return std::move(peaks);
+	return peaks;
 }
 
-bool OriginSimplex::insert(PointRef ref)
+template <typename Tr>
+typename HullT<Tr>::PointRefVec HullT<Tr>::getPolygon()
 {
-	bool done = false;
+	assert(NDim == 2);
 
-	if (_size < 2)
+	PointRefVec poly;
+
+	if (_initialized)
 	{
-		if (_size == 1 && (*ref == *front())) return false;
-		push_back(ref);
-		_size++;
+		//in 2D every hull facet is an edge, the neighbor across one of its
+		//vertices is the hull facet sharing the other
+		Simplex* start = _hull.m_hullSimplex;
+		Simplex* S = start;
+		assert(_hull.isMember(*S, clarkson93::simplex::HULL));
+
+		PointRef a = S->V[S->iPeak == 1 ? 2 : 1];
+		do
+		{
+			poly.push_back(a);
+			PointRef b = S->V[0];
+			for (int i = 0; i < NDim + 1; ++i)
+			{
+				if (i != S->iPeak && S->V[i] != a) b = S->V[i];
+			}
+			S = _hull.neighborAcross(*S, a);
+			a = b;
+		} while (S != start);
 	}
 	else
 	{
-		val_t dx0 = (*ref)[0] - (*front())[0],
-			dx1 = (*ref)[0] - (*back())[0],
-			dy0 = (*ref)[1] - (*front())[1],
-			dy1 = (*ref)[1] - (*back())[1];
-		if ((!dx0 && !dx1) || (!dy0 && !dy1)) {} //duplicate
-		else if (dx0 * dy1 == dx1 * dy0)
-		{//in a line
-			if ( !(dx0>0 ^ dx1>0) && !(dy0>0 ^ dy1>0) )
-			{//out of facet
-				std::abs(dx0) < std::abs(dx1) ? pop_front() : pop_back();
-				push_back(ref);
+		for (auto ref : _origin)
+		{
+			poly.push_back(ref);
+		}
+	}
+
+	Polygon::orient(poly);
+	Polygon::strict(poly);
+	return poly;
+}
+
+template <typename Tr>
+void HullT<Tr>::getFacets(typename Visibility::Facets& facets)
+{
+	facets.clear();
+	if (!_initialized) return;
+
+	auto push = [&facets](Simplex& S)
+	{
+		Val_t scale = 0;
+		for (int i = 0; i < NDim + 1; ++i)
+		{
+			if (i == S.iPeak) continue;
+			for (int d = 0; d < NDim; ++d) scale = std::max(scale, (Val_t)fabs((*S.V[i])[d]));
+		}
+		facets.push(S.n, S.o, scale);
+	};
+
+	if (NDim == 2)
+	{//walk the hull facets in O(h) as getPolygon does
+		Simplex* start = _hull.m_hullSimplex;
+		Simplex* S = start;
+		PointRef a = S->V[S->iPeak == 1 ? 2 : 1];
+		do
+		{
+			push(*S);
+			PointRef b = S->V[0];
+			for (int i = 0; i < NDim + 1; ++i)
+			{
+				if (i != S->iPeak && S->V[i] != a) b = S->V[i];
+			}
+			S = _hull.neighborAcross(*S, a);
+			a = b;
+		} while (S != start);
+	}
+	else
+	{//neighbors of a hull facet across its base vertices are hull facets
+		_walk.assign(1, _hull.m_hullSimplex);
+		_seen.clear();
+		_seen.insert(_hull.m_hullSimplex);
+		while (!_walk.empty())
+		{
+			Simplex* S = _walk.back();
+			_walk.pop_back();
+			push(*S);
+			for (int i = 0; i < NDim + 1; ++i)
+			{
+				if (i != (int)S->iPeak && _seen.insert(S->N[i]).second) _walk.push_back(S->N[i]);
 			}
 		}
-		else
+	}
+}
+
+template <typename Tr>
+void OriginSimplexT<Tr>::clear()
+{
+	std::list<PointRef>::clear();
+	_deferred.clear();
+	_size = 0;
+}
+
+template <typename Tr>
+bool OriginSimplexT<Tr>::_collinear(const Point& a, const Point& b, const Point& c)
+{//collinear iff so in the projection onto every pair of coordinates
+	for (int d = 0; d < NDim; ++d)
+	{
+		for (int e = d + 1; e < NDim; ++e)
 		{
-			done = true;
-			push_back(ref);
+			Eigen::Matrix<val_t, 2, 1> pa(a[d], a[e]), pb(b[d], b[e]), pc(c[d], c[e]);
+			if (predicates::orient2d(pa, pb, pc) != 0) return false;
 		}
 	}
+	return true;
+}
+
+template <typename Tr>
+bool OriginSimplexT<Tr>::_independent(PointRef ref) const
+{
+	std::vector<const Point*> pts;
+	for (PointRef p : *this)
+	{
+		pts.push_back(p);
+	}
+
+	if (_size == 2) return !_collinear(*pts[0], *pts[1], *ref);
+	if (_size == 3 && NDim == 3) return predicates::orient3d(*pts[0], *pts[1], *pts[2], *ref) != 0;
+
+	Eigen::Matrix<val_t, Eigen::Dynamic, NDim> edges(_size, NDim);
+	for (size_t i = 1; i < _size; ++i)
+	{
+		edges.row(i - 1) = *pts[i] - *pts[0];
+	}
+	edges.row(_size - 1) = *ref - *pts[0];
+	return edges.fullPivLu().rank() == (int)_size;
+}
+
+template <typename Tr>
+bool OriginSimplexT<Tr>::insert(PointRef ref)
+{
+	if (_size < 2)
+	{
+		if (_size == 1 && (*ref == *this->front())) return false;
+		this->push_back(ref);
+		_size++;
+	}
+	else if (*ref == *this->front() || *ref == *this->back()) {} //duplicate
+	else if (_size == 2 && _collinear(*this->front(), *this->back(), *ref))
+	{//in a line, out of the segment if on the same side of both ends
+		const Point d0 = *ref - *this->front(), d1 = *ref - *this->back();
+		bool out = true;
+		for (int d = 0; d < NDim; ++d)
+		{
+			out &= (d0[d] > 0) == (d1[d] > 0);
+		}
+		if (out)
+		{
+			d0.squaredNorm() < d1.squaredNorm() ? this->pop_front() : this->pop_back();
+			this->push_back(ref);
+		}
+	}
+	else if (_independent(ref))
+	{
+		this->push_back(ref);
+		_size++;
+	}
+	else
+	{
+		_deferred.push_back(ref);
+	}
 	
-	return done;
-}
\ No newline at end of file
+	return _size == NDim + 1;
+}
+
+template class OriginSimplexT<Traits>;
+template class OriginSimplexT<TraitsF>;
+template class HullT<Traits>;
+template class HullT<TraitsF>;
+template class OriginSimplexT<Traits3>;
+template class HullT<Traits3>;
@@ -13,45 +13,224 @@
 #define _HULL_H
 
 #include <list>
+#include <unordered_set>
 
 #include "Points.h"
+#include "Visibility.h"
+#include "PointSoA.h"
 
-class OriginSimplex: public std::list<PointRef>
+const int WALK_STEPS = 4096; //steps of a local walk before it falls back to the origin walk
+
+template <typename Tr>
+class OriginSimplexT: public std::list<typename Tr::PointRef>
 {
-	using val_t 	= Val_t;
-	using facet_t 	= std::pair<PointRef, PointRef>; //2D so faect is a line segment
+	static const int NDim = Tr::NDim;
+	using val_t 	= typename Tr::Scalar;
+	using Point 	= typename Tr::Point;
+	using PointRef 	= typename Tr::PointRef;
 
 public:
-	OriginSimplex() :_size(0) {}
+	OriginSimplexT() :_size(0) {}
+
+	//
+	// @brief: collect NDim + 1 affinely independent points, a point on the
+	// 		   line of the first two moves an end of their segment outward or
+	// 		   is dropped, a point dependent on more of them is deferred
+	// @return: whether the simplex is complete
+	//
 	bool insert(PointRef ref);
+	void clear();
+
+	//
+	// @brief: points set aside by insert, to be inserted into the hull
+	//
+	const std::vector<PointRef>& deferred() const {return _deferred;}
 
 private:
-	size_t		_size;
+	static bool _collinear(const Point& a, const Point& b, const Point& c);
+
+	//
+	// @brief: whether ref is affinely independent of the collected points
+	//
+	bool _independent(PointRef ref) const;
+
+	size_t					_size;
+	std::vector<PointRef>	_deferred;
 };
 
-class Hull
+template <typename Tr>
+class HullT
 {
 public:
-	using Simplex = Triangulation_t::Simplex;
+	static const int NDim 	= Tr::NDim;
+	using Val_t 			= typename Tr::Scalar;
+	using Point 			= typename Tr::Point;
+	using PointRef 			= typename Tr::PointRef;
+	using PointRefVec 		= std::vector<PointRef>;
+	using PointVec 			= PointVecT<Tr>;
+	using PointSoA 			= PointSoAT<Tr>;
+	using Visibility 		= VisibilityT<Val_t, NDim>;
+	using OriginSimplex 	= OriginSimplexT<Tr>;
+	using Triangulation_t 	= Triangulation<Tr>;
+	using Simplex 			= typename Triangulation_t::Simplex;
+	using Region 			= typename Triangulation_t::Region;
+	using Locator 			= typename Triangulation_t::Locator;
 
 public:
-	Hull(int n = NDim + 1);
+	HullT(int n = NDim + 1);
 
 	bool insert(PointRef p);
 
+	//
+	// @brief: insert in blocks of FILTER_BLOCK, points seeing no facet of
+	// 		   the hull at the start of a block are dropped without a walk
+	//
 	void insert(std::vector<PointRef>& pointRefs);
 
+	//
+	// @brief: same as above, the filter reads coordinates from view instead
+	// 		   of gathering them, view point i must be *pointRefs[i]
+	//
+	void insert(std::vector<PointRef>& pointRefs, const typename PointSoA::View& view);
+
 	void insert(PointVec& points);
 
+	//
+	// @brief: insert points concurrently into this one hull
+	// @param: thrNum: number of threads sharing the triangulation
+	// 		   batch: number of points located speculatively per round,
+	// 		   points whose x-visible regions overlap retry next round
+	//
+	void insertSpeculative(PointRefVec& pointRefs, int thrNum, int batch);
+
+	//
+	// @brief: insert a batch by a conflict graph (Clarkson-Shor), each
+	// 		   pending point keeps one hull facet it sees and each facet the
+	// 		   list of those points, so no insertion walks; when facets are
+	// 		   replaced their points move to a new facet they see, or are
+	// 		   dropped as interior if they see none
+	//
+	void insertConflict(PointRefVec& pointRefs);
+
+	//
+	// @brief: locate a point by walking the finite simplices from where the
+	// 		   previous locate ended instead of walking from the origin
+	// 		   simplex, short when consecutive points are close, as in a
+	// 		   biased randomized insertion order; off by default
+	//
+	void setLocalWalk(bool on) {_localWalk = on;}
+
 	void clear();
 
+	//
+	// @brief: clear and make room for n points, the reserved capacity is
+	// 		   kept so a reused hull does not allocate simplices again
+	//
+	void reset(int n);
+
+	//
+	// @brief: whether n more points surely fit in the reserved simplices,
+	// 		   each inserted point adds at most NDim simplices in 2D, in
+	// 		   higher dimensionality a guess, since insert reseeds the hull
+	// 		   itself whenever a point does not fit
+	//
+	bool fits(int n) const;
+
+	//
+	// @brief: rebuild the hull from its own peaks, which frees the simplices
+	// 		   of interior points, and grows the reserved capacity if the
+	// 		   peaks plus n more points would not fit
+	//
+	void reseed(int n = 0);
+
 	std::vector<PointRef> getPeaks();
 
+	//
+	// @brief: hull vertices in counter-clockwise order, walking the hull
+	// 		   facets in O(h), 2 dimensionality only
+	//
+	std::vector<PointRef> getPolygon();
+
+	//
+	// @brief: normals and offsets of the current hull facets
+	//
+	void getFacets(typename Visibility::Facets& facets);
+
 private:
+	//
+	// @brief: whether n more simplices fit in the reserved ones
+	//
+	bool _room(size_t n) const;
+
+	//
+	// @brief: insert refs[first, last) that see the current hull
+	// @param: coords: coordinates of refs[first, last), gathered into
+	// 		   _coords if nullptr
+	//
+	void _insertBlock(std::vector<PointRef>& refs, int first, int last, const Val_t* const* coords);
+
+	//
+	// @brief: remove from refs[first, end) the points that see no facet in
+	// 		   _facets, keeping the order of the rest
+	//
+	void _dropInside(PointRefVec& refs, int first);
+
+	//
+	// @brief: set bit i of _mask if refs[first + i] sees a facet in _facets
+	//
+	void _filter(const PointRefVec& refs, int first, int last, const Val_t* const* coords);
+
+	//
+	// @brief: conflict graph of insertConflict, point i of refs is pending
+	// 		   while _conflict[i], a hull facet it sees, is not nullptr
+	//
+	void _attach(int i, Simplex* S);
+	void _locate(const PointRefVec& refs, int i);
+
+	//
+	// @brief: walk the finite simplices toward p from the one the previous
+	// 		   walk ended in, or the origin simplex
+	// @return: a hull simplex p sees, the finite simplex holding p if p is
+	// 		   not outside the hull, nullptr if the walk gave up
+	//
+	Simplex* _walkNear(PointRef p);
+	int _index(const Simplex* S) const {return S - _hull.m_sMgr.data();}
+
 	Triangulation_t		_hull;
 	OriginSimplex		_origin;
 	bool				_initialized;
+	bool				_reseeding;		//inserting the peaks of a reseed
+	bool				_overflow;		//a reseed ran out of simplices
+	bool				_localWalk;		//locate by walking from the previous locate
+	uint32_t			_walkRand;		//xorshift state picking the first facet of each walk step
+	Simplex*			_walkFrom;		//finite simplex the last local walk ended in
 	std::hash<Point>	_ptHash;
+
+	//scratch of block insertion
+	typename Visibility::Facets	_facets;
+	std::vector<Val_t>		_coords[NDim];
+	std::vector<uint64_t>	_mask;
+
+	//scratch of speculative insertion, kept across calls, a region per
+	//point of the batch and a locator per thread
+	std::vector<Region>		_regions;
+	std::vector<Locator>	_locators;
+
+	//scratch of conflict insertion, lists are linked through _next
+	std::vector<Simplex*>	_conflict;
+	std::vector<int>		_head;
+	std::vector<int>		_next;
+
+	//scratch of walking hull facets above 2 dimensionality
+	std::vector<Simplex*>		_walk;
+	std::unordered_set<Simplex*>	_seen;
 };
 
+template <typename Tr> const int OriginSimplexT<Tr>::NDim;
+template <typename Tr> const int HullT<Tr>::NDim;
+
+typedef OriginSimplexT<Traits>	OriginSimplex;
+typedef HullT<Traits>			Hull;
+typedef HullT<Traits3>			Hull3;
+
 #endif
\ No newline at end of file
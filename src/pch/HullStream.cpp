@@ -0,0 +1,65 @@
+//
+//  HullStream.cpp
+//
+//	by Jiahuan.Liu
+//	jiahaun.liu@outlook.com
+//
+//  03/18/2017
+//
+
+#include "HullStream.h"
+
+HullStream::HullStream(int thrNum)
+	:_thrNum(thrNum > 0 ? thrNum : omp_get_max_threads())
+{
+}
+
+int HullStream::append(PointVec& batch)
+{
+	return append(batch.begin(), batch.end(), [](PointVec::iterator itr){return &(*itr);});
+}
+
+PointVec HullStream::hull() const
+{
+	PointVec res;
+	res.reserve(_poly.size());
+	for (auto& ref : _poly)
+	{
+		res.push_back(*ref);
+	}
+	return res;
+}
+
+void HullStream::clear()
+{
+	_hull.clear();
+	_points.clear();
+	_poly.clear();
+}
+
+void HullStream::_compact(int n)
+{
+	PointVec peaks = hull();
+	_points.assign(peaks.begin(), peaks.end());
+	_hull.reset(2 * (_points.size() + n));
+	for (auto& p : _points)
+	{
+		_hull.insert(&p);
+	}
+}
+
+void HullStream::_insert(const PointVec& survivors)
+{
+	if (survivors.empty()) return;
+
+	const int n = survivors.size();
+	if (!_hull.fits(n)) _compact(n);
+
+	for (auto& p : survivors)
+	{
+		_points.push_back(p);
+		_hull.insert(&_points.back());
+	}
+
+	_poly = NDim == 2 ? _hull.getPolygon() : _hull.getPeaks();
+}
@@ -0,0 +1,98 @@
+//
+//  HullStream.h
+//
+//	@brief: live convex hull fed by batches of points
+//
+//	by Jiahuan.Liu
+//	jiahaun.liu@outlook.com
+//
+//  03/18/2017
+//
+
+#ifndef _HULLSTREAM_H
+#define _HULLSTREAM_H
+
+#include <deque>
+#include <omp.h>
+
+#include "Hull.h"
+#include "Polygon.h"
+
+class HullStream
+{
+public:
+	//
+	// @param: thrNum: threads filtering a batch, 0 for omp_get_max_threads()
+	//
+	HullStream(int thrNum = 0);
+
+	//
+	// @brief: add a batch of points, points strictly inside the current
+	// 		   hull are discarded in parallel and only survivors are inserted
+	// @param: beg, end: specify input points, should be RandomAccessItrator
+	// 		   getRef: method to get PointRef from itr
+	// @return: number of survivors inserted
+	//
+	template <typename Itr, typename GetRef>
+	int append(Itr beg, Itr end, GetRef getRef);
+
+	int append(PointVec& batch);
+
+	//
+	// @brief: current hull points, counter-clockwise in 2 dimensionality
+	//
+	PointVec hull() const;
+
+	//
+	// @brief: number of points kept for the live hull
+	//
+	size_t size() const {return _points.size();}
+
+	void clear();
+
+private:
+	//
+	// @brief: keep only the current hull points, and make room for
+	// 		   n more, so memory stays proportional to hull plus batch
+	//
+	void _compact(int n);
+
+	void _insert(const PointVec& survivors);
+
+	Hull				_hull;
+	std::deque<Point>	_points; //owns inserted points, refs into it stay valid
+	PointRefVec			_poly;	 //current hull, refs into _points
+	int					_thrNum;
+};
+
+template <typename Itr, typename GetRef>
+int HullStream::append(Itr beg, Itr end, GetRef getRef)
+{
+	const int size = end - beg;
+	const bool filter = NDim == 2 && _poly.size() >= 3;
+
+	std::vector<char> keep(size, 1);
+	int cnt = size;
+	if (filter)
+	{
+		cnt = 0;
+		#pragma omp parallel for schedule(static) reduction(+:cnt) shared(keep) num_threads(_thrNum)
+		for (int i = 0; i < size; ++i)
+		{
+			keep[i] = !Polygon::inside(_poly, *getRef(beg + i));
+			cnt += keep[i];
+		}
+	}
+
+	PointVec survivors;
+	survivors.reserve(cnt);
+	for (int i = 0; i < size; ++i)
+	{
+		if (keep[i]) survivors.push_back(*getRef(beg + i));
+	}
+
+	_insert(survivors);
+	return cnt;
+}
+
+#endif
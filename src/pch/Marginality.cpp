@@ -16,25 +16,33 @@ const int Scale = 1e3;
 
 using val_t = Marginality::val_t;
 
-val_t Marginality::entropy(val_t v1, val_t v2)
+template <typename Tr>
+val_t MarginalityT<Tr>::entropy(val_t v1, val_t v2)
 {
     val_t sum = v1 + v2;
     return entropy(v1, v2, sum);
 }
 
-val_t Marginality::entropy(val_t v1, val_t v2, val_t sum)
+template <typename Tr>
+val_t MarginalityT<Tr>::entropy(val_t v1, val_t v2, val_t sum)
 {
     if (v1 == 0 || v2 == 0) return 0;
     val_t p1 = v1 / sum, p2 = v2 / sum;
     return -(p1 * log2(p1) + p2 * log2(p2)) * Scale;
 }
 
-void Marginality::accumulate(val_t& v1, val_t v2)
+template <typename Tr>
+void MarginalityT<Tr>::accumulate(val_t& v1, val_t v2)
 {
     v1 *= v2;
 }
 
-void Marginality::initialize(val_t& v)
+template <typename Tr>
+void MarginalityT<Tr>::initialize(val_t& v)
 {
     v = 1;
-}
\ No newline at end of file
+}
+
+template class MarginalityT<Traits>;
+template class MarginalityT<TraitsF>;
+template class MarginalityT<Traits3>;
@@ -1,7 +1,7 @@
 //
 //  Marginality.h
 //
-//	@brief: marginality sort of vector of points with 2 dimensionality
+//	@brief: marginality sort of vector of points of any dimensionality
 //
 //	by Jiahuan.Liu
 //	jiahaun.liu@outlook.com
@@ -15,34 +15,54 @@
 #include <vector>
 #include <type_traits>
 #include <math.h>
+#include <algorithm>
 #include <omp.h>
 
-#include "Points.h" //NDim
+#include "Points.h"
 #include "ParalSort.h"
+#include "PointSoA.h"
 
-class Marginality
+template <typename Tr>
+class MarginalityT
 {
 public:
+	static const int NDim = Tr::NDim;
 	using val_t = double;
+	using PointSoA = PointSoAT<Tr>;
 public:
+	//
+	// @param: thrNum: number of threads, all the runtime has by default
+	//
 	template <typename Itr, typename GetRef, 
 		typename R = std::vector<typename std::iterator_traits<Itr>::value_type> >
-	static R sort(Itr beg, Itr end, GetRef getRef);
+	static R sort(Itr beg, Itr end, GetRef getRef, int thrNum = omp_get_max_threads());
+
+	//
+	// @brief: marginality order of the points of view, read in place
+	// @return: indices into view, most marginal first
+	//
+	static std::vector<int> order(const typename PointSoA::View& view, int thrNum = omp_get_max_threads());
 private:
+	//
+	// @brief: shared by sort and order
+	// @param: coordAt: coordAt(i, d) is coordinate d of point i
+	//
+	template <typename CoordAt>
+	static std::vector<int> _order(int size, CoordAt coordAt, int thrNum);
+
 	static val_t entropy(val_t v1, val_t v2);
 	static val_t entropy(val_t v1, val_t v2, val_t sum);
 	static void accumulate(val_t& v1, val_t v2);
 	static void initialize(val_t& v);
 };
 
+template <typename Tr>
 template <typename Itr, typename GetRef, 
 	typename R>
-R Marginality::sort(Itr beg, Itr end, GetRef getRef)
+R MarginalityT<Tr>::sort(Itr beg, Itr end, GetRef getRef, int thrNum)
 {
 	const int size = end - beg;
 
-	std::vector<int> vRanks[NDim];
-
 	std::vector<Itr> idx2itr;
 	idx2itr.reserve(size);
 	for (Itr itr = beg; itr != end; ++itr)
@@ -50,7 +70,35 @@ R Marginality::sort(Itr beg, Itr end, GetRef getRef)
 		idx2itr.push_back(itr);
 	}
 
-	#pragma omp parallel for schedule(dynamic, 1) shared(vRanks, getRef, idx2itr)
+	std::vector<int> order = _order(size, 
+		[&](int i, int d){return (*getRef(idx2itr[i]))[d];}, thrNum);
+
+	R res;
+	res.reserve(size); //####container operations on R object should be wrap as template specialization
+	
+	for (int idx : order)
+	{//avoid random access requirement of R
+		res.push_back(*idx2itr[idx]);
+	}
+	return res;
+}
+
+template <typename Tr>
+std::vector<int> MarginalityT<Tr>::order(const typename PointSoA::View& view, int thrNum)
+{
+	return _order(view.size(), [&](int i, int d){return view.c[d][i];}, thrNum);
+}
+
+template <typename Tr>
+template <typename CoordAt>
+std::vector<int> MarginalityT<Tr>::_order(int size, CoordAt coordAt, int thrNum)
+{
+	//dimensions are sorted side by side, each with its share of threads
+	const int dimThrNum = std::max(thrNum / NDim, 1);
+
+	std::vector<int> vRanks[NDim];
+
+	#pragma omp parallel for schedule(dynamic, 1) shared(vRanks, coordAt) num_threads(std::min(thrNum, NDim))
 	for (int d = 0; d < NDim; ++d)
 	{
 		std::vector<std::pair<val_t, int>> pos;
@@ -58,7 +106,7 @@ R Marginality::sort(Itr beg, Itr end, GetRef getRef)
 		
 		for (int i = 0; i < size; ++i)
 		{
-			pos.emplace_back((*getRef(idx2itr[i]))[d], i);
+			pos.emplace_back(coordAt(i, d), i);
 		}
 
 		vRanks[d] = std::vector<int>(size);
@@ -66,7 +114,7 @@ R Marginality::sort(Itr beg, Itr end, GetRef getRef)
 
 		Timer t;
 		t.start();
-		ParalSort::mergesort(pos.begin(), pos.end(), 2);//##TODO: thrNum
+		ParalSort::mergesort(pos.begin(), pos.end(), dimThrNum);
 		//LOG_INFO << "sort: " << t.stop();
 
 		//#pragma omp parallel for schedule(static) shared(ranks, pos, d)
@@ -97,19 +145,19 @@ R Marginality::sort(Itr beg, Itr end, GetRef getRef)
 
 	Timer t;
 	t.start();
-	ParalSort::mergesort(vals.begin(), vals.end(), 2);//####TODO: thrNum
+	ParalSort::mergesort(vals.begin(), vals.end(), thrNum);
 	//LOG_INFO << "sort: " << t.stop();
-	
-	R res;
-	res.reserve(size); //####container operations on R object should be wrap as template specialization
-	
-	for (auto& val : vals)
-	{//avoid random access requirement of R
-		////
-		//LOG_INFO << val.first << " " << (*getRef(idx2itr[val.second]))[0] << " " << (*getRef(idx2itr[val.second]))[1];
-		res.push_back(*idx2itr[val.second]);
+
+	std::vector<int> res(size);
+	for (int i = 0; i < size; ++i)
+	{
+		res[i] = vals[i].second;
 	}
 	return std::move(res);
 }
 
+template <typename Tr> const int MarginalityT<Tr>::NDim;
+
+typedef MarginalityT<Traits> Marginality;
+
 #endif
\ No newline at end of file
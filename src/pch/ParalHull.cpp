@@ -15,7 +15,79 @@
 #include "Hull.h"
 #include "omp.h"
 
-PointRefVec ParalHull::getRefs(const PointVec& vec)
+int ParalHullBase::s_thrNum = omp_get_max_threads();
+bool ParalHullBase::s_roundLog = false;
+const double ParalHullBase::s_dirs[8][2] = {{1, 0}, {1, 1}, {0, 1}, {-1, 1}, {-1, 0}, {-1, -1}, {0, -1}, {1, -1}};
+
+void ParalHullBase::setThrNum(int thrNum)
+{
+	s_thrNum = std::max(thrNum, 1);
+}
+
+int ParalHullBase::getThrNum()
+{
+	return s_thrNum;
+}
+
+int ParalHullBase::_thrNum(int thrNum)
+{
+	return thrNum > 0 ? thrNum : s_thrNum;
+}
+
+template <typename Tr>
+std::vector<typename ParalHullT<Tr>::Hull>& ParalHullT<Tr>::_poolStorage()
+{
+	static thread_local std::vector<Hull> s_pool;
+	return s_pool;
+}
+
+template <typename Tr>
+std::vector<typename ParalHullT<Tr>::Hull>& ParalHullT<Tr>::_pool(int count)
+{
+	_prepare(_poolStorage(), count);
+	return _poolStorage();
+}
+
+template <typename Tr>
+void ParalHullT<Tr>::_prepare(std::vector<Hull>& hulls, int count)
+{
+	if ((int)hulls.size() < count) hulls.resize(count);
+}
+
+template <typename Tr>
+void ParalHullT<Tr>::releasePool()
+{
+	std::vector<Hull>().swap(_poolStorage());
+}
+
+void ParalHullBase::setRoundLog(bool on)
+{
+	s_roundLog = on;
+}
+
+ParalHullBase::RoundPolicy ParalHullBase::fixpoint()
+{
+	return [](const RoundInfo& info)
+	{
+		return info.currCnt == info.prevCnt ? R_SEQUENTIAL : R_CONTINUE;
+	};
+}
+
+ParalHullBase::RoundPolicy ParalHullBase::adaptive(double maxRatio, double minCost)
+{
+	return [maxRatio, minCost](const RoundInfo& info)
+	{
+		//another round is worth it only if this one removed enough and took long enough
+		if (info.currCnt > maxRatio * info.prevCnt || info.cost < minCost)
+		{
+			return R_MERGE;
+		}
+		return R_CONTINUE;
+	};
+}
+
+template <typename Tr>
+typename ParalHullT<Tr>::PointRefVec ParalHullT<Tr>::getRefs(const PointVec& vec)
 {
 	PointRefVec res;
 	res.reserve(vec.size());
@@ -27,7 +99,8 @@ PointRefVec ParalHull::getRefs(const PointVec& vec)
 }
 
 ////TODO combine them
-PointVec ParalHull::getPts(const PointRefVec& vec)
+template <typename Tr>
+typename ParalHullT<Tr>::PointVec ParalHullT<Tr>::getPts(const PointRefVec& vec)
 {
 	PointVec res;
 	res.reserve(vec.size());
@@ -36,4 +109,377 @@ PointVec ParalHull::getPts(const PointRefVec& vec)
 		res.push_back(*ref);
 	}
 	return std::move(res);
-}
\ No newline at end of file
+}
+template <typename Tr>
+std::vector<size_t> ParalHullT<Tr>::getIndices(const PointRefVec& vec, const Point* base)
+{
+	std::vector<size_t> res;
+	res.reserve(vec.size());
+	for (const auto& ref : vec)
+	{
+		res.push_back(ref - base);
+	}
+	return res;
+}
+
+template <typename Tr>
+void ParalHullT<Tr>::_quickHull(PointRef a, PointRef b, PointRefVec& pts, PointRefVec& res)
+{
+	const int size = pts.size();
+	if (size == 0) return;
+
+	//farthest point from a->b, per chunk then reduced
+	const int nChunk = (size + QH_GRAIN - 1) / QH_GRAIN;
+	std::vector<int> best(nChunk);
+	for (int c = 0; c < nChunk; ++c)
+	{
+		#pragma omp task shared(pts, best) firstprivate(c) if(nChunk > 1)
+		{
+			const int first = c * QH_GRAIN, last = std::min(first + QH_GRAIN, size);
+			int k = first;
+			Val_t dist = Polygon::cross(*a, *b, *pts[first]);
+			for (int i = first + 1; i < last; ++i)
+			{
+				Val_t d = Polygon::cross(*a, *b, *pts[i]);
+				if (d > dist) dist = d, k = i;
+			}
+			best[c] = k;
+		}
+	}
+	#pragma omp taskwait
+
+	int far = best[0];
+	for (int c = 1; c < nChunk; ++c)
+	{
+		if (Polygon::cross(*a, *b, *pts[best[c]]) > Polygon::cross(*a, *b, *pts[far])) far = best[c];
+	}
+	PointRef c = pts[far];
+
+	PointRefVec left, right;
+	_quickSplit(a, c, b, pts, left, right);
+	PointRefVec().swap(pts);
+
+	PointRefVec leftRes, rightRes;
+	#pragma omp task shared(left, leftRes) if(left.size() >= (size_t)QH_GRAIN)
+	_quickHull(a, c, left, leftRes);
+	_quickHull(c, b, right, rightRes);
+	#pragma omp taskwait
+
+	res.reserve(leftRes.size() + rightRes.size() + 1);
+	res.insert(res.end(), leftRes.begin(), leftRes.end());
+	res.push_back(c);
+	res.insert(res.end(), rightRes.begin(), rightRes.end());
+}
+
+template <typename Tr>
+void ParalHullT<Tr>::_quickSplit(PointRef a, PointRef c, PointRef b, const PointRefVec& pts, PointRefVec& left, PointRefVec& right)
+{
+	//without c, split by the line a->b into its left and right sides
+	PointRef l0 = a, l1 = c ? c : b, r0 = c ? c : b, r1 = c ? b : a;
+
+	const int size = pts.size();
+	const int nChunk = (size + QH_GRAIN - 1) / QH_GRAIN;
+	std::vector<int> counts(2 * (nChunk + 1), 0);
+	std::vector<char> side(size);
+
+	for (int k = 0; k < nChunk; ++k)
+	{
+		#pragma omp task shared(pts, counts, side) firstprivate(k) if(nChunk > 1)
+		{
+			const int first = k * QH_GRAIN, last = std::min(first + QH_GRAIN, size);
+			int nLeft = 0, nRight = 0;
+			for (int i = first; i < last; ++i)
+			{
+				const Point& p = *pts[i];
+				side[i] = Polygon::turn(*l0, *l1, p) > 0 ? 1 : Polygon::turn(*r0, *r1, p) > 0 ? 2 : 0;
+				nLeft += side[i] == 1;
+				nRight += side[i] == 2;
+			}
+			counts[2 * (k + 1)] = nLeft;
+			counts[2 * (k + 1) + 1] = nRight;
+		}
+	}
+	#pragma omp taskwait
+
+	for (int k = 0; k < nChunk; ++k)
+	{
+		counts[2 * (k + 1)] += counts[2 * k];
+		counts[2 * (k + 1) + 1] += counts[2 * k + 1];
+	}
+	left.resize(counts[2 * nChunk]);
+	right.resize(counts[2 * nChunk + 1]);
+
+	for (int k = 0; k < nChunk; ++k)
+	{
+		#pragma omp task shared(pts, counts, side, left, right) firstprivate(k) if(nChunk > 1)
+		{
+			const int first = k * QH_GRAIN, last = std::min(first + QH_GRAIN, size);
+			int l = counts[2 * k], r = counts[2 * k + 1];
+			for (int i = first; i < last; ++i)
+			{
+				if (side[i] == 1) left[l++] = pts[i];
+				else if (side[i] == 2) right[r++] = pts[i];
+			}
+		}
+	}
+	#pragma omp taskwait
+}
+
+//
+// @brief: whether q is more clockwise than best seen from p, or as far
+// 		   clockwise but farther, so collinear hull points are skipped
+//
+template <typename P>
+static bool moreClockwise(const P& p, const P& q, const P& best)
+{
+	const int turn = Polygon::turn(p, best, q);
+	if (turn != 0) return turn < 0;
+	return fabs(q[0] - p[0]) + fabs(q[1] - p[1]) > fabs(best[0] - p[0]) + fabs(best[1] - p[1]);
+}
+
+template <typename Tr>
+int ParalHullT<Tr>::_tangent(const PointRefVec& poly, const Point& p)
+{
+	const int n = poly.size();
+	auto v = [&poly, n](int i) -> const Point& {return *poly[i % n];};
+	//edge i is seen from p, the angle of v(i) seen from p does not increase
+	auto seen = [&](int i) {return Polygon::turn(v(i), v(i + 1), p) <= 0;};
+	auto valid = [&](int i)
+	{
+		return v(i) != p && Polygon::turn(p, v(i), v(i + n - 1)) >= 0 && Polygon::turn(p, v(i), v(i + 1)) >= 0;
+	};
+
+	if (n >= 3)
+	{
+		//angles of vertices seen from p are cyclically bitonic, q is the minimum,
+		//it is the first unseen edge after the seen ones, in (lo, hi]
+		const bool up0 = !seen(0);
+		int lo = 0, hi = n;
+		if (!(up0 && seen(n - 1)))
+		{
+			while (hi - lo > 1)
+			{
+				const int mid = (lo + hi) / 2;
+				const bool upMid = !seen(mid);
+				const int side = Polygon::turn(p, v(0), v(mid));
+				bool after;
+				if (up0) after = !upMid || side > 0;
+				else after = !upMid && side < 0;
+				(after ? lo : hi) = mid;
+			}
+		}
+		if (valid(hi)) return hi % n;
+	}
+
+	//few vertices, or p on the polygon so angles degenerate
+	int best = -1;
+	for (int i = 0; i < n; ++i)
+	{
+		if (v(i) != p && (best < 0 || moreClockwise(p, v(i), v(best)))) best = i;
+	}
+	return best;
+}
+
+template <typename Tr>
+bool ParalHullT<Tr>::_wrap(const std::vector<PointRefVec>& polys, int m, int thrNum, PointRefVec& res)
+{
+	const int nGroup = polys.size();
+
+	PointRef first = nullptr;
+	for (auto& poly : polys)
+	{
+		for (PointRef ref : poly)
+		{
+			if (!first || Polygon::less(*ref, *first)) first = ref;
+		}
+	}
+	if (!first) return true;
+
+	PointRef curr = first;
+	for (int step = 0; step < m; ++step)
+	{
+		res.push_back(curr);
+		const Point& p = *curr;
+
+		PointRef next = nullptr;
+		#pragma omp parallel shared(next) num_threads(std::min(thrNum, nGroup))
+		{
+			PointRef local = nullptr;
+			#pragma omp for schedule(static)
+			for (int g = 0; g < nGroup; ++g)
+			{
+				int t = _tangent(polys[g], p);
+				if (t >= 0 && (!local || moreClockwise(p, *polys[g][t], *local))) local = polys[g][t];
+			}
+			#pragma omp critical
+			{
+				if (local && (!next || moreClockwise(p, *local, *next))) next = local;
+			}
+		}
+
+		if (!next || *next == *first) return true;
+		curr = next;
+	}
+	return false;
+}
+
+template <typename Tr>
+typename ParalHullT<Tr>::PointVec ParalHullT<Tr>::_extremes(const typename PointSoA::View& view, int nDir, int thrNum)
+{
+	const int size = view.size();
+	const int step = 8 / nDir;
+	const Val_t* x = view.coord(0);
+	const Val_t* y = view.coord(1);
+
+	std::vector<int> extremes(thrNum * nDir, -1);
+	#pragma omp parallel shared(extremes) num_threads(thrNum)
+	{
+		int* local = &extremes[omp_get_thread_num() * nDir];
+		#pragma omp for schedule(static)
+		for (int i = 0; i < size; ++i)
+		{
+			for (int k = 0; k < nDir; ++k)
+			{
+				const double* d = s_dirs[k * step];
+				if (local[k] < 0 || d[0] * x[i] + d[1] * y[i] > d[0] * x[local[k]] + d[1] * y[local[k]])
+					local[k] = i;
+			}
+		}
+	}
+
+	PointVec poly;
+	for (int k = 0; k < nDir; ++k)
+	{
+		const double* d = s_dirs[k * step];
+		int best = -1;
+		for (int tid = 0; tid < thrNum; ++tid)
+		{
+			int i = extremes[tid * nDir + k];
+			if (i >= 0 && (best < 0 || d[0] * x[i] + d[1] * y[i] > d[0] * x[best] + d[1] * y[best]))
+				best = i;
+		}
+		if (best < 0) continue;
+		Point p = view.point(best);
+		if (poly.empty() || (poly.back() != p && poly.front() != p))
+			poly.push_back(p);
+	}
+
+	return poly;
+}
+
+template <typename Tr>
+typename ParalHullT<Tr>::Visibility::Facets ParalHullT<Tr>::_edgeFacets(const PointVec& poly)
+{
+	const int nEdge = poly.size();
+	typename Visibility::Facets facets;
+	for (int e = 0; e < nEdge; ++e)
+	{
+		const Point& a = poly[e];
+		const Point& b = poly[(e + 1) % nEdge];
+		Point n = Point::Zero();
+		n[0] = a[1] - b[1];
+		n[1] = b[0] - a[0];
+		Val_t scale = (fabs(n[0]) + fabs(n[1])) * std::max(std::max(fabs(a[0]), fabs(a[1])), std::max(fabs(b[0]), fabs(b[1])));
+		facets.push(n, n[0] * a[0] + n[1] * a[1], scale);
+	}
+	return facets;
+}
+
+template <typename Tr>
+typename ParalHullT<Tr>::PointVec ParalHullT<Tr>::prefilter(const typename PointSoA::View& view, int nDir, int thrNum, FilterStats* stats)
+{
+	assert(nDir == 4 || nDir == 8);
+
+	const int size = view.size();
+	thrNum = _thrNum(thrNum);
+
+	Timer t;
+	t.start();
+
+	PointVec poly;
+	if (NDim == 2) poly = _extremes(view, nDir, thrNum);
+
+	int extremeCost = t.stop();
+	t.start();
+
+	PointVec res;
+	const int nEdge = poly.size();
+
+	if (nEdge < 3)
+	{//degenerate or no polygon, nothing is strictly inside
+		res.resize(size);
+		#pragma omp parallel for schedule(static) shared(res) num_threads(thrNum)
+		for (int i = 0; i < size; ++i) res[i] = view.point(i);
+	}
+	else
+	{
+		typename Visibility::Facets facets = _edgeFacets(poly);
+		std::vector<int> counts(thrNum + 1, 0);
+
+		#pragma omp parallel shared(counts, res, facets) num_threads(thrNum)
+		{
+			const int tid = omp_get_thread_num(), nThr = omp_get_num_threads();
+			const int first = (long)size * tid / nThr, last = (long)size * (tid + 1) / nThr;
+
+			std::vector<uint64_t> mask((last - first + 63) / 64 + 1);
+			Visibility::outside(view.sub(first, last).coords(), last - first, facets, mask.data());
+
+			int cnt = 0;
+			for (int i = 0; i < last - first; ++i)
+			{
+				cnt += mask[i / 64] >> (i % 64) & 1;
+			}
+			counts[tid + 1] = cnt;
+
+			#pragma omp barrier
+			#pragma omp single
+			{
+				for (int i = 0; i < nThr; ++i) counts[i + 1] += counts[i];
+				res.resize(counts[nThr]);
+			}
+
+			for (int i = 0, k = counts[tid]; i < last - first; ++i)
+			{
+				if (mask[i / 64] >> (i % 64) & 1) res[k++] = view.point(first + i);
+			}
+		}
+	}
+
+	if (stats)
+	{
+		stats->extreme = extremeCost;
+		stats->filter = t.stop();
+		stats->survivors = res.size();
+	}
+	return res;
+}
+
+template <typename Tr>
+typename ParalHullT<Tr>::ret_type ParalHullT<Tr>::sequentialWithFilter(Timer& timer, const typename PointSoA::View& view, int nDir, int thrNum, FilterStats* stats)
+{
+	auto getRefFromPtItr = [](typename PointVec::iterator itr){return &(*itr);};
+	auto survivors = prefilter(view, nDir, thrNum, stats);
+
+	Timer t;
+	t.start();
+	auto res = sequential(timer, survivors.begin(), survivors.end(), getRefFromPtItr, false, thrNum);
+	if (stats) stats->hull = t.stop();
+	return res;
+}
+
+template <typename Tr>
+typename ParalHullT<Tr>::ret_type ParalHullT<Tr>::manualParalWithFilter(Timer& timer, const typename PointSoA::View& view, int nDir, int thrNum, FilterStats* stats)
+{
+	auto getRefFromPtItr = [](typename PointVec::iterator itr){return &(*itr);};
+	auto survivors = prefilter(view, nDir, thrNum, stats);
+
+	Timer t;
+	t.start();
+	auto res = manualParal(timer, survivors.begin(), survivors.end(), getRefFromPtItr, false, thrNum);
+	if (stats) stats->hull = t.stop();
+	return res;
+}
+
+template class ParalHullT<Traits>;
+template class ParalHullT<TraitsF>;
+template class ParalHullT<Traits3>;
@@ -13,6 +13,7 @@
 #define _PARALHULL_H
 
 #include <algorithm>
+#include <functional>
 #include <omp.h>
 #include <math.h>
 #include <assert.h>
@@ -20,55 +21,326 @@
 #include "Hull.h"
 #include "UnitTest.h"
 #include "Marginality.h"
+#include "Brio.h"
+#include "Polygon.h"
+#include "ParalSort.h"
 
-const int MIN_SIZE = NDim + 1;
-const int THR_NUM = 2;
+const int SPECU_BATCH = 64; //points located per thread in each speculative round
+const int TASK_CHUNKS = 16; //chunks per thread of task partitioning
+const int CELL_POINTS = 16; //expected points per grid cell of spatial partitioning
+const int MAX_CELLS = 1024; //grid cells per side of spatial partitioning
+const int QH_GRAIN = 1 << 14; //points per task of quickHull
+const int CHAN_GROUP = 256; //least first group size of chan, squared per round
 
-class ParalHull
+//
+// @brief: the part of ParalHull shared by every traits instantiation,
+// 		   engine settings included
+//
+class ParalHullBase
+{
+public:
+	//
+	// @brief: how _parallel splits input among threads
+	//
+	enum Partition
+	{
+		P_STATIC,	//one contiguous slice per thread
+		P_TASK,		//many small chunks as tasks, absorbed by per-thread hulls
+		P_SPATIAL	//angular sectors around the center, interior grid cells skipped,
+					//P_STATIC above 2 dimensionality
+	};
+
+	//
+	// @brief: how sequential feeds points to its hull
+	//
+	enum Insertion
+	{
+		I_WALK,		//input order, each point walks from the origin simplex
+		I_BRIO,		//biased randomized insertion order, each point walks from where the previous one ended
+		I_CONFLICT	//conflict graph, each point keeps a visible facet, no walks
+	};
+
+	//
+	// @brief: per-stage report of a filtered run, times in ms
+	//
+	struct FilterStats
+	{
+		int extreme;	//extreme point reduction
+		int filter;		//discarding points inside the extreme polygon
+		int hull;		//hull of the survivors
+		int survivors;
+	};
+
+	//
+	// @brief: what manualParal does after a round of parallel hulls
+	//
+	enum RoundAction
+	{
+		R_CONTINUE,		//run another parallel round on the survivors
+		R_SEQUENTIAL,	//one sequential hull of the survivors
+		R_MERGE			//merge the sub-hull polygons, 2 dimensionality only
+	};
+
+	//
+	// @brief: measurement of a finished round, cost in ms
+	//
+	struct RoundInfo
+	{
+		int round;
+		int prevCnt;	//points fed to the round
+		int currCnt;	//points kept by the round
+		double cost;
+	};
+
+	using RoundPolicy = std::function<RoundAction(const RoundInfo&)>;
+
+	//
+	// @brief: round policies for manualParal
+	// 		   fixpoint: rounds until the count stops changing, then sequential
+	// 		   adaptive: finishes once a round keeps more than maxRatio of its
+	// 		   input or costs less than minCost ms, by merge, which is
+	// 		   sequential above 2 dimensionality
+	//
+	static RoundPolicy fixpoint();
+	static RoundPolicy adaptive(double maxRatio = 0.5, double minCost = 1.0);
+
+	//
+	// @brief: engine default thread number, used when a call passes 0,
+	// 		   initialized to omp_get_max_threads()
+	//
+	static void setThrNum(int thrNum);
+	static int getThrNum();
+
+	//
+	// @brief: log every round decision of manualParal, off by default
+	//
+	static void setRoundLog(bool on);
+protected:
+	static int _thrNum(int thrNum);
+
+	static int s_thrNum;
+	static bool s_roundLog;
+	static const double s_dirs[8][2]; //prefilter directions in counter-clockwise order
+};
+
+template <typename Tr>
+class ParalHullT: public ParalHullBase
 {
 public:
-	using ret_type = PointVec;
+	static const int NDim 		= Tr::NDim;
+	static const int MIN_SIZE 	= NDim + 1;
+	using Val_t 		= typename Tr::Scalar;
+	using Point 		= typename Tr::Point;
+	using PointRef 		= typename Tr::PointRef;
+	using PointRefVec 	= std::vector<PointRef>;
+	using PointVec 		= PointVecT<Tr>;
+	using PointSoA 		= PointSoAT<Tr>;
+	using Hull 			= HullT<Tr>;
+	using Marginality 	= MarginalityT<Tr>;
+	using Visibility 	= VisibilityT<Val_t, NDim>;
+	using ret_type 		= PointVec;
 public:
 	//
 	// @brief: public interface of algorithm
 	// @param: beg, end: specify input points, should be RandomAccessItrator
 	// 		   getRef: method to get PointRef from itr
+	// 		   thrNum: number of threads, 0 for the engine default
+	// 		   ins: I_BRIO and I_CONFLICT override bSort; with I_BRIO each
+	// 		   locate walks the finite simplices from the simplex of the
+	// 		   previous point, which proves an interior point inside in a
+	// 		   few steps
 	// @return: number of anti-origin points in resulting polygon
 	//
 	template <typename Itr, typename GetRef>
-	static ret_type sequential(Timer& timer, Itr beg, Itr end, GetRef getRef, bool bSort = false);
+	static ret_type sequential(Timer& timer, Itr beg, Itr end, GetRef getRef, bool bSort = false, int thrNum = 0,
+		Insertion ins = I_WALK);
+
+	template <typename Itr, typename GetRef>
+	static ret_type manualParal(Timer& timer, Itr beg, Itr end, GetRef getRef, int prevCnt, bool bSort = false, int thrNum = 0);
+
+	template <typename Itr, typename GetRef>
+	static ret_type manualParal(Timer& timer, Itr beg, Itr end, GetRef getRef, bool bSort = false, int thrNum = 0, Partition part = P_STATIC,
+		const RoundPolicy& policy = fixpoint());
+
+	template <typename Itr, typename GetRef>
+	static ret_type manualParalWithPresort(Timer& timer, Itr beg, Itr end, GetRef getRef, int thrNum = 0);
+
+	template <typename Itr, typename GetRef>
+	static ret_type specuParal(Timer& timer, Itr beg, Itr end, GetRef getRef, int thrNum = 0);
+
+	//
+	// @brief: one parallel round, then sub-hull polygons are merged pairwise
+	// 		   in a parallel tree reduction; above 2 dimensionality the
+	// 		   sub-hulls get one sequential hull instead
+	//
+	template <typename Itr, typename GetRef>
+	static ret_type mergeParal(Timer& timer, Itr beg, Itr end, GetRef getRef, bool bSort = false, int thrNum = 0, Partition part = P_STATIC);
+
+	//
+	// @brief: Andrew's monotone chain without triangulation, 2 dimensionality
+	// 		   only; refs are sorted by ParalSort::mergesort, each x-ordered
+	// 		   block builds its chains in parallel, and the block hulls are
+	// 		   stitched by one more chain over their vertices
+	//
+	template <typename Itr, typename GetRef>
+	static ret_type monotoneChain(Timer& timer, Itr beg, Itr end, GetRef getRef, int thrNum = 0);
+
+	//
+	// @brief: QuickHull, 2 dimensionality only; every split recurses as an
+	// 		   OpenMP task, farthest point search and partitioning of large
+	// 		   sets run over QH_GRAIN chunks as tasks too
+	//
+	template <typename Itr, typename GetRef>
+	static ret_type quickHull(Timer& timer, Itr beg, Itr end, GetRef getRef, int thrNum = 0);
 
+	//
+	// @brief: Chan's algorithm, 2 dimensionality only; the points left by
+	// 		   prefilter are split into groups of m, at least one per thread,
+	// 		   which get mini-hulls from the block filtered Hull::insert in
+	// 		   parallel, then the hull is wrapped by binary-searched tangents,
+	// 		   m squared until h <= m
+	//
 	template <typename Itr, typename GetRef>
-	static ret_type manualParal(Timer& timer, Itr beg, Itr end, GetRef getRef, int prevCnt, bool bSort = false);
+	static ret_type chan(Timer& timer, Itr beg, Itr end, GetRef getRef, int thrNum = 0);
 
+	//
+	// @brief: Akl-Toussaint heuristic, drops points strictly inside the
+	// 		   polygon of extreme points in nDir (4 or 8) directions, tested
+	// 		   in blocks on Visibility::outside, which keeps points within
+	// 		   rounding of an edge; every point survives above 2 dimensionality
+	// @return: refs of surviving points, in input order
+	//
 	template <typename Itr, typename GetRef>
-	static ret_type manualParal(Timer& timer, Itr beg, Itr end, GetRef getRef, bool bSort = false);
+	static PointRefVec prefilter(Itr beg, Itr end, GetRef getRef, int nDir = 8, int thrNum = 0, FilterStats* stats = nullptr);
 
 	template <typename Itr, typename GetRef>
-	static ret_type manualParalWithPresort(Timer& timer, Itr beg, Itr end, GetRef getRef);
+	static ret_type sequentialWithFilter(Timer& timer, Itr beg, Itr end, GetRef getRef, int nDir = 8, int thrNum = 0, FilterStats* stats = nullptr);
+
+	template <typename Itr, typename GetRef>
+	static ret_type manualParalWithFilter(Timer& timer, Itr beg, Itr end, GetRef getRef, int nDir = 8, int thrNum = 0, FilterStats* stats = nullptr);
+
+	//
+	// @brief: prefilter reading a structure of arrays in place, the polygon
+	// 		   test runs on Visibility::outside over the coordinate arrays
+	// @return: copies of surviving points, in input order, since hulls keep
+	// 		   refs to points and a view has none
+	//
+	static PointVec prefilter(const typename PointSoA::View& view, int nDir = 8, int thrNum = 0, FilterStats* stats = nullptr);
+
+	static ret_type sequentialWithFilter(Timer& timer, const typename PointSoA::View& view, int nDir = 8, int thrNum = 0, FilterStats* stats = nullptr);
 
+	static ret_type manualParalWithFilter(Timer& timer, const typename PointSoA::View& view, int nDir = 8, int thrNum = 0, FilterStats* stats = nullptr);
+
+	//
+	// @brief: manualParal whose rounds pass PointRefs into the input buffer
+	// 		   instead of copies of the points
+	// @return: refs of hull points, see getPts() and getIndices()
+	//
 	template <typename Itr, typename GetRef>
-	static ret_type specuParal(Timer& timer, Itr beg, Itr end, GetRef getRef);
+	static PointRefVec manualParalRefs(Timer& timer, Itr beg, Itr end, GetRef getRef, bool bSort = false, int thrNum = 0, Partition part = P_STATIC,
+		const RoundPolicy& policy = fixpoint());
 
 	static PointRefVec getRefs(const PointVec& vec);
 	static PointVec getPts(const PointRefVec& vec);
+
+	//
+	// @brief: positions of refs in the input buffer starting at base
+	//
+	static std::vector<size_t> getIndices(const PointRefVec& vec, const Point* base);
+
+	//
+	// @brief: free the hull pool of the calling thread, see _pool()
+	//
+	static void releasePool();
 private:
+	//
+	// @brief: hulls owned by the calling thread, reset and reused across
+	// 		   rounds and calls so their simplex buffers are allocated once
+	// @param: count: minimal number of hulls in the pool
+	//
+	static std::vector<Hull>& _pool(int count);
+
+	static std::vector<Hull>& _poolStorage();
+
+	static void _prepare(std::vector<Hull>& hulls, int count);
+
 	//
 	// @brief: internal implementation of parallelization
 	// @param: hull, hulls: for hull structures return
-	// @return: Point vector of hull points
+	// 		   Vec: PointVec for copies of hull points, PointRefVec for refs
+	// @return: vector of hull points
 	//
-	/*template <typename Itr, typename GetRef>
-	static PointRefVec _sequential(Itr beg, Itr end, GetRef getRef, Hull& hull);
+	template <typename Vec, typename Itr, typename GetRef>
+	static Vec _sequential(Itr beg, Itr end, GetRef getRef, Hull& hull, bool bSort, int thrNum);
 
-	template <typename Itr, typename GetRef>
-	static std::vector<PointRefVec> _parallel(Itr beg, Itr end, GetRef getRef, std::vector<Hull>& hulls);*/
+	template <typename Vec, typename Itr, typename GetRef>
+	static std::vector<Vec> _parallel(Itr beg, Itr end, GetRef getRef, std::vector<Hull>& hulls, bool bSort, int thrNum, Partition part = P_STATIC);
+
+	template <typename Vec, typename Itr, typename GetRef>
+	static std::vector<Vec> _parallelTasks(Itr beg, Itr end, GetRef getRef, std::vector<Hull>& hulls, bool bSort, int thrNum);
+
+	template <typename Vec, typename Itr, typename GetRef>
+	static std::vector<Vec> _parallelSpatial(Itr beg, Itr end, GetRef getRef, std::vector<Hull>& hulls, bool bSort, int thrNum);
 
+	template <typename Vec, typename Itr, typename GetRef>
+	static Vec _manualParal(Itr beg, Itr end, GetRef getRef, bool bSort, int thrNum, Partition part, const RoundPolicy& policy);
+
+	//
+	// @brief: extreme points along nDir directions, as a counter-clockwise
+	// 		   polygon without duplicates, which lies inside the hull
+	//
 	template <typename Itr, typename GetRef>
-	static PointVec _sequential(Itr beg, Itr end, GetRef getRef, Hull& hull, bool bSort);
+	static PointVec _extremes(Itr beg, Itr end, GetRef getRef, int nDir, int thrNum);
+
+	static PointVec _extremes(const typename PointSoA::View& view, int nDir, int thrNum);
+
+	//
+	// @brief: edges of a counter-clockwise polygon as facets for
+	// 		   Visibility::outside, p is strictly left of edge a->b iff
+	// 		   n.p > n.a, n being a->b turned left
+	//
+	static typename Visibility::Facets _edgeFacets(const PointVec& poly);
+
+	//
+	// @brief: hull vertices strictly between a and b, from a to b, of points
+	// 		   strictly left of a->b, runs inside a parallel region
+	//
+	static void _quickHull(PointRef a, PointRef b, PointRefVec& pts, PointRefVec& res);
+
+	//
+	// @brief: split pts into points strictly left of a->c and of c->b,
+	// 		   or of a->b and of b->a when c is null
+	//
+	static void _quickSplit(PointRef a, PointRef c, PointRef b, const PointRefVec& pts, PointRefVec& left, PointRefVec& right);
+
+	//
+	// @brief: index of the vertex q of a counter-clockwise convex polygon
+	// 		   with every vertex left of or on p->q, in O(log h) when p is
+	// 		   outside the polygon, -1 if every vertex equals p
+	//
+	static int _tangent(const PointRefVec& poly, const Point& p);
+
+	//
+	// @brief: wrap the hull of mini-hulls counter-clockwise from their
+	// 		   lexicographically lowest vertex, at most m steps
+	// @return: false if the hull has more than m vertices
+	//
+	static bool _wrap(const std::vector<PointRefVec>& polys, int m, int thrNum, PointRefVec& res);
 
 	template <typename Itr, typename GetRef>
-	static std::vector<PointVec> _parallel(Itr beg, Itr end, GetRef getRef, std::vector<Hull>& hulls, bool bSort);
+	static void _insert(Itr beg, Itr end, GetRef getRef, Hull& hull, bool bSort, int thrNum);
+
+	static void _collect(PointRefVec&& refs, PointVec& res) {res = getPts(refs);}
+	static void _collect(PointRefVec&& refs, PointRefVec& res) {res = std::move(refs);}
+
+	//
+	// @brief: getRef for the intermediate vectors between rounds
+	//
+	struct DerefItr
+	{
+		PointRef operator()(typename PointVec::iterator itr) const {return &(*itr);}
+		PointRef operator()(typename PointRefVec::iterator itr) const {return *itr;}
+	};
 
 	template <typename Vec>
 	static int _count(const std::vector<Vec>& vecs);
@@ -78,55 +350,77 @@ private:
 
 	template <typename Vec>
 	static Vec _flatten(const std::vector<Vec>& vecs);
+
+	//
+	// @brief: merge counter-clockwise convex polygons into polys[0]
+	//
+	template <typename Vec>
+	static Vec _reduce(std::vector<Vec>& polys, int thrNum);
 };
 
+template <typename Tr> const int ParalHullT<Tr>::NDim;
+template <typename Tr> const int ParalHullT<Tr>::MIN_SIZE;
+
+typedef ParalHullT<Traits>	ParalHull;
+typedef ParalHullT<TraitsF>	ParalHullF;
+typedef ParalHullT<Traits3>	ParalHull3;
+
+template <typename Tr>
+template <typename Vec, typename Itr, typename GetRef>
+Vec ParalHullT<Tr>::_sequential(Itr beg, Itr end, GetRef getRef, Hull& hull, bool bSort, int thrNum)
+{
+	_insert(beg, end, getRef, hull, bSort, thrNum);
+
+	Vec res;
+	_collect(NDim == 2 ? hull.getPolygon() : hull.getPeaks(), res);
+	return res;
+}
+
+template <typename Tr>
 template <typename Itr, typename GetRef>
-PointVec ParalHull::_sequential(Itr beg, Itr end, GetRef getRef, Hull& hull, bool bSort)
+void ParalHullT<Tr>::_insert(Itr beg, Itr end, GetRef getRef, Hull& hull, bool bSort, int thrNum)
 {
 	////
 	//LOG_INFO << "Seq: " << end - beg << " from " << beg - beg << " to " << end - beg;
 
-	std::vector<Point> sortedList;
-
 	if (bSort)
 	{
 		Timer t;
 		t.start();
-		sortedList = Marginality::sort(beg, end, getRef);
-		//####TODO: getRef
-		auto getSortedRef = [](std::vector<Point>::iterator itr){return &(*itr);};
-		////
-		//LOG_INFO << "sort: " << t.stop();
-		for (Point& p: sortedList)
+		//sort refs rather than points, so hull refs stay in the input buffer
+		PointRefVec refs;
+		refs.reserve(end - beg);
+		for (Itr itr = beg; itr != end; ++itr)
 		{
-			//LOG_INFO << "(" << p[0] << "," << p[1] << ")";
-			hull.insert(&p);
+			refs.push_back(getRef(itr));
 		}
+		PointRefVec sortedList = Marginality::sort(refs.begin(), refs.end(), DerefItr(), thrNum);
+		////
+		//LOG_INFO << "sort: " << t.stop();
+		hull.insert(sortedList);
 	}
 	else
 	{
+		//blocks of the chunk are filtered against the hull before walking
+		PointRefVec refs;
+		refs.reserve(end - beg);
 		for (Itr itr = beg; itr != end; ++itr)
 		{
 			//LOG_INFO << "(" << (*getRef(itr))[0] << "," << (*getRef(itr))[1] << ")";
-			hull.insert(getRef(itr));
+			refs.push_back(getRef(itr));
 		}
+		hull.insert(refs);
 	}
-
-	////
-	auto peaks = hull.getPeaks();
-	for (auto& p : peaks)
-	{
-		//LOG_INFO << "Hull: " << (*p)[0] << " " << (*p)[1];
-	}
-
-	return getPts(hull.getPeaks());
 }
 
-template <typename Itr, typename GetRef>
-std::vector<PointVec> ParalHull::_parallel(Itr beg, Itr end, GetRef getRef, std::vector<Hull>& hulls, bool bSort)
+template <typename Tr>
+template <typename Vec, typename Itr, typename GetRef>
+std::vector<Vec> ParalHullT<Tr>::_parallel(Itr beg, Itr end, GetRef getRef, std::vector<Hull>& hulls, bool bSort, int thrNum, Partition part)
 {
+	if (part == P_TASK) return _parallelTasks<Vec>(beg, end, getRef, hulls, bSort, thrNum);
+	if (part == P_SPATIAL && NDim == 2) return _parallelSpatial<Vec>(beg, end, getRef, hulls, bSort, thrNum);
+
 	const int size = end - beg;
-	int thrNum = THR_NUM;//####TODO
 	int len = ceil(size / thrNum);
 	
 	while (len <= MIN_SIZE && thrNum > 1)
@@ -135,13 +429,13 @@ std::vector<PointVec> ParalHull::_parallel(Itr beg, Itr end, GetRef getRef, std:
 		len = ceil(size / thrNum);
 	}
 
-	hulls.reserve(thrNum);
+	_prepare(hulls, thrNum);
 	for (int i = 0; i < thrNum; ++i)
 	{
-		hulls.emplace_back(len);
+		hulls[i].reset(len);
 	}
 
-	std::vector<PointVec> results(thrNum);
+	std::vector<Vec> results(thrNum);
 
 	#pragma omp parallel shared(results, len, beg, end, getRef, hulls) num_threads(thrNum) //num_threads must be set
 	{
@@ -149,15 +443,176 @@ std::vector<PointVec> ParalHull::_parallel(Itr beg, Itr end, GetRef getRef, std:
 		Itr first = beg + len * tid, 
 			last = (tid == thrNum - 1 ? end : first + len);
 			
-		auto result = _sequential(first, last, getRef, hulls[tid], bSort);
+		//each chunk already owns one thread, so presort it sequentially
+		auto result = _sequential<Vec>(first, last, getRef, hulls[tid], bSort, 1);
 		results[tid] = std::move(result);
 	}
 
 	return std::move(results);
 }
 
+template <typename Tr>
+template <typename Vec, typename Itr, typename GetRef>
+std::vector<Vec> ParalHullT<Tr>::_parallelTasks(Itr beg, Itr end, GetRef getRef, std::vector<Hull>& hulls, bool bSort, int thrNum)
+{
+	const int size = end - beg;
+	int chunk = std::max(size / (thrNum * TASK_CHUNKS), MIN_SIZE);
+
+	while (size / chunk < thrNum && thrNum > 1)
+	{
+		thrNum /= 2;
+	}
+
+	//a thread may absorb more than its share, hull reseeds itself when full
+	_prepare(hulls, thrNum);
+	for (int i = 0; i < thrNum; ++i)
+	{
+		hulls[i].reset(2 * size / thrNum + chunk);
+	}
+
+	#pragma omp parallel shared(beg, getRef, hulls) num_threads(thrNum)
+	#pragma omp single nowait
+	for (int first = 0; first < size; first += chunk)
+	{
+		const int last = std::min(first + chunk, size);
+
+		//tied task without scheduling points, so hulls[tid] stays private
+		#pragma omp task firstprivate(first, last)
+		{
+			Hull& hull = hulls[omp_get_thread_num()];
+			if (!hull.fits(last - first)) hull.reseed(last - first);
+			_insert(beg + first, beg + last, getRef, hull, bSort, 1);
+		}
+	}
+
+	std::vector<Vec> results(thrNum);
+	for (int i = 0; i < thrNum; ++i)
+	{
+		_collect(NDim == 2 ? hulls[i].getPolygon() : hulls[i].getPeaks(), results[i]);
+	}
+
+	return results;
+}
+
+template <typename Tr>
+template <typename Vec, typename Itr, typename GetRef>
+std::vector<Vec> ParalHullT<Tr>::_parallelSpatial(Itr beg, Itr end, GetRef getRef, std::vector<Hull>& hulls, bool bSort, int thrNum)
+{
+	assert(NDim == 2);
+	const int size = end - beg;
+	if (size == 0) return {};
+
+	while (size < thrNum * MIN_SIZE && thrNum > 1)
+	{
+		thrNum /= 2;
+	}
+
+	//the extreme polygon is inside the hull, so are grid cells inside it
+	PointVec poly = _extremes(beg, end, getRef, 8, thrNum);
+	Val_t x0 = poly[0][0], x1 = x0, y0 = poly[0][1], y1 = y0;
+	for (auto& p : poly)
+	{
+		x0 = std::min(x0, p[0]), x1 = std::max(x1, p[0]);
+		y0 = std::min(y0, p[1]), y1 = std::max(y1, p[1]);
+	}
+
+	const int grid = std::max(1, std::min((int)sqrt(size / CELL_POINTS), MAX_CELLS));
+	const Val_t w = (x1 - x0) / grid, h = (y1 - y0) / grid;
+	const Val_t xs = w > 0 ? 1 / w : 0, ys = h > 0 ? 1 / h : 0;
+	const Val_t cx = (x0 + x1) / 2, cy = (y0 + y1) / 2;
+
+	std::vector<char> inner(grid * grid, 0);
+	if (poly.size() >= 3)
+	{
+		poly.push_back(poly.front());
+		#pragma omp parallel for schedule(static) shared(inner, poly) num_threads(thrNum)
+		for (int c = 0; c < grid * grid; ++c)
+		{//inside if all four corners are strictly left of every edge
+			const Val_t cellX = x0 + (c % grid) * w, cellY = y0 + (c / grid) * h;
+			char in = 1;
+			for (int k = 0; k < 4 && in; ++k)
+			{
+				Point corner = poly[0];
+				corner[0] = cellX + (k & 1) * w;
+				corner[1] = cellY + (k >> 1) * h;
+				for (size_t e = 0; e + 1 < poly.size() && in; ++e)
+				{
+					in = Polygon::turn(poly[e], poly[e + 1], corner) > 0;
+				}
+			}
+			inner[c] = in;
+		}
+	}
+
+	//bucket surviving refs by sector: count, prefix sum, then scatter
+	std::vector<int> sector(size);
+	std::vector<int> counts(thrNum * thrNum, 0);
+	std::vector<int> offsets(thrNum + 1, 0);
+	PointRefVec buckets;
+
+	#pragma omp parallel shared(sector, counts, offsets, buckets, inner) num_threads(thrNum)
+	{
+		const int tid = omp_get_thread_num(), nThr = omp_get_num_threads();
+		const int first = (long)size * tid / nThr, last = (long)size * (tid + 1) / nThr;
+		int* local = &counts[tid * thrNum];
+
+		for (int i = first; i < last; ++i)
+		{
+			const Point& p = *getRef(beg + i);
+			const int gx = std::min((int)((p[0] - x0) * xs), grid - 1);
+			const int gy = std::min((int)((p[1] - y0) * ys), grid - 1);
+			if (inner[gy * grid + gx])
+			{
+				sector[i] = -1;
+				continue;
+			}
+			const double a = atan2(p[1] - cy, p[0] - cx);
+			sector[i] = std::min((int)((a + M_PI) / (2 * M_PI) * thrNum), thrNum - 1);
+			local[sector[i]]++;
+		}
+
+		#pragma omp barrier
+		#pragma omp single
+		{//counts of thread tid in sector k become its write cursor there
+			for (int k = 0; k < thrNum; ++k)
+			{
+				int sum = offsets[k];
+				for (int t = 0; t < nThr; ++t)
+				{
+					std::swap(sum, counts[t * thrNum + k]);
+					sum += counts[t * thrNum + k];
+				}
+				offsets[k + 1] = sum;
+			}
+			buckets.resize(offsets[thrNum]);
+		}
+
+		for (int i = first; i < last; ++i)
+		{
+			if (sector[i] >= 0) buckets[local[sector[i]]++] = getRef(beg + i);
+		}
+	}
+
+	_prepare(hulls, thrNum);
+	for (int k = 0; k < thrNum; ++k)
+	{
+		hulls[k].reset(offsets[k + 1] - offsets[k]);
+	}
+
+	std::vector<Vec> results(thrNum);
+	#pragma omp parallel for schedule(dynamic, 1) shared(results, buckets, offsets, hulls) num_threads(thrNum)
+	for (int k = 0; k < thrNum; ++k)
+	{
+		auto first = buckets.begin() + offsets[k], last = buckets.begin() + offsets[k + 1];
+		results[k] = _sequential<Vec>(first, last, DerefItr(), hulls[k], bSort, 1);
+	}
+
+	return results;
+}
+
+template <typename Tr>
 template <typename Vec>
-int ParalHull::_count(const std::vector<Vec>& vecs)
+int ParalHullT<Tr>::_count(const std::vector<Vec>& vecs)
 {
 	int res = 0;
 	for (auto& v : vecs)
@@ -167,8 +622,9 @@ int ParalHull::_count(const std::vector<Vec>& vecs)
 	return res;
 }
 
+template <typename Tr>
 template <typename Vec>
-Vec ParalHull::_flatten(const std::vector<Vec>& vecs, int count)
+Vec ParalHullT<Tr>::_flatten(const std::vector<Vec>& vecs, int count)
 {
 	Vec res;
 	res.reserve(count);
@@ -178,25 +634,69 @@ Vec ParalHull::_flatten(const std::vector<Vec>& vecs, int count)
 	return std::move(res);
 }
 
+template <typename Tr>
 template <typename Vec>
-Vec ParalHull::_flatten(const std::vector<Vec>& vecs)
+Vec ParalHullT<Tr>::_flatten(const std::vector<Vec>& vecs)
 {
 	return _flatten(vecs, _count(vecs));
 }
 
+template <typename Tr>
+template <typename Vec>
+Vec ParalHullT<Tr>::_reduce(std::vector<Vec>& polys, int thrNum)
+{
+	const int n = polys.size();
+	for (int step = 1; step < n; step *= 2)
+	{
+		#pragma omp parallel for schedule(dynamic, 1) shared(polys) num_threads(thrNum)
+		for (int i = 0; i < n - step; i += 2 * step)
+		{
+			polys[i] = Polygon::merge(polys[i], polys[i + step]);
+		}
+	}
+	return std::move(polys.front());
+}
+
+template <typename Tr>
 template <typename Itr, typename GetRef>
-ParalHull::ret_type ParalHull::sequential(Timer& timer, Itr beg, Itr end, GetRef getRef, bool bSort)
+typename ParalHullT<Tr>::ret_type ParalHullT<Tr>::sequential(Timer& timer, Itr beg, Itr end, GetRef getRef, bool bSort, int thrNum,
+	Insertion ins)
 {
 	int size = end - beg;
-	Hull hull(size);
-	return _sequential(beg, end, getRef, hull, bSort);
+	Hull& hull = _pool(1).front();
+	hull.reset(size);
+	if (ins == I_WALK)
+	{
+		return _sequential<PointVec>(beg, end, getRef, hull, bSort, _thrNum(thrNum));
+	}
+
+	PointRefVec refs;
+	refs.reserve(size);
+	for (Itr itr = beg; itr != end; ++itr)
+	{
+		refs.push_back(getRef(itr));
+	}
+	if (ins == I_BRIO)
+	{
+		PointRefVec order = BrioT<Tr>::sort(refs.begin(), refs.end(), DerefItr(), _thrNum(thrNum));
+		hull.setLocalWalk(true);
+		PointVec res = _sequential<PointVec>(order.begin(), order.end(), DerefItr(), hull, false, _thrNum(thrNum));
+		hull.setLocalWalk(false);
+		return res;
+	}
+
+	hull.insertConflict(refs);
+	PointVec res;
+	_collect(NDim == 2 ? hull.getPolygon() : hull.getPeaks(), res);
+	return res;
 }
 
+template <typename Tr>
 template <typename Itr, typename GetRef>
-ParalHull::ret_type ParalHull::manualParal(Timer& timer, Itr beg, Itr end, GetRef getRef, int prevCnt, bool bSort)
+typename ParalHullT<Tr>::ret_type ParalHullT<Tr>::manualParal(Timer& timer, Itr beg, Itr end, GetRef getRef, int prevCnt, bool bSort, int thrNum)
 {
-	std::vector<Hull> hulls;
-	auto results = _parallel(beg, end, getRef, hulls, bSort);
+	thrNum = _thrNum(thrNum);
+	auto results = _parallel<PointVec>(beg, end, getRef, _pool(thrNum), bSort, thrNum);
 	int currCnt = _count(results);
 
 	if (results.empty()) return {};
@@ -204,55 +704,432 @@ ParalHull::ret_type ParalHull::manualParal(Timer& timer, Itr beg, Itr end, GetRe
 
 	//timer.pause();//####
 	auto nextStep = _flatten(results, currCnt);
-	//auto getRefFromRefItr = [](PointRefVec::iterator itr){return *itr;};
-	auto getRefFromPtItr = [](PointVec::iterator itr){return &(*itr);};
+	//auto getRefFromRefItr = [](typename PointRefVec::iterator itr){return *itr;};
+	auto getRefFromPtItr = [](typename PointVec::iterator itr){return &(*itr);};
 
-	hulls.clear();
 	//timer.resume();//####
 
 	return (currCnt == prevCnt) ? 
-		sequential(timer, nextStep.begin(), nextStep.end(), getRefFromPtItr, bSort) :
-		manualParal(timer, nextStep.begin(), nextStep.end(), getRefFromPtItr, currCnt, bSort);
+		sequential(timer, nextStep.begin(), nextStep.end(), getRefFromPtItr, bSort, thrNum) :
+		manualParal(timer, nextStep.begin(), nextStep.end(), getRefFromPtItr, currCnt, bSort, thrNum);
+}
+
+template <typename Tr>
+template <typename Itr, typename GetRef>
+typename ParalHullT<Tr>::ret_type ParalHullT<Tr>::manualParal(Timer& /*timer*/, Itr beg, Itr end, GetRef getRef, bool bSort, int thrNum, Partition part,
+	const RoundPolicy& policy)
+{
+	return _manualParal<PointVec>(beg, end, getRef, bSort, _thrNum(thrNum), part, policy);
 }
 
+template <typename Tr>
 template <typename Itr, typename GetRef>
-ParalHull::ret_type ParalHull::manualParal(Timer& timer, Itr beg, Itr end, GetRef getRef, bool bSort)
+typename ParalHullT<Tr>::PointRefVec ParalHullT<Tr>::manualParalRefs(Timer& /*timer*/, Itr beg, Itr end, GetRef getRef, bool bSort, int thrNum, Partition part,
+	const RoundPolicy& policy)
+{
+	return _manualParal<PointRefVec>(beg, end, getRef, bSort, _thrNum(thrNum), part, policy);
+}
+
+template <typename Tr>
+template <typename Vec, typename Itr, typename GetRef>
+Vec ParalHullT<Tr>::_manualParal(Itr beg, Itr end, GetRef getRef, bool bSort, int thrNum, Partition part, const RoundPolicy& policy)
 {
-	std::vector<Hull> hulls;
-	auto results = _parallel(beg, end, getRef, hulls, bSort);
+	static const char* actions[] = {"continue", "sequential", "merge"};
+
+	std::vector<Hull>& hulls = _pool(thrNum);
+	double start = omp_get_wtime();
+	auto results = _parallel<Vec>(beg, end, getRef, hulls, bSort, thrNum, part);
 	int currCnt = _count(results), prevCnt = end - beg;
 
 	if (results.empty()) return {};
 	else if (results.size() == 1) return std::move(results.front());
 
-	//auto getRefFromRefItr = [](PointRefVec::iterator itr){return *itr;};
-	auto getRefFromPtItr = [](PointVec::iterator itr){return &(*itr);};
-
-	//timer.pause();//####
-	while (currCnt != prevCnt)
+	RoundAction action;
+	for (int round = 1; ; ++round)
 	{
-		prevCnt = currCnt;
+		RoundInfo info = {round, prevCnt, currCnt, (omp_get_wtime() - start) * 1e3};
+		action = policy(info);
+		if (action == R_MERGE && NDim != 2) action = R_SEQUENTIAL;
+
+		if (s_roundLog)
+		{
+			LOG_INFO << "round " << round << ": " << prevCnt << " -> " << currCnt
+				<< " (" << (prevCnt ? (double)currCnt / prevCnt : 0) << ") " << info.cost << "ms, " << actions[action];
+		}
+		if (action != R_CONTINUE) break;
 
+		prevCnt = currCnt;
 		auto nextStep = _flatten(results, currCnt);
-		//timer.resume();//####
 
-		std::vector<Hull> hulls;
-		results = _parallel(nextStep.begin(), nextStep.end(), getRefFromPtItr, hulls, bSort);
+		start = omp_get_wtime();
+		results = _parallel<Vec>(nextStep.begin(), nextStep.end(), DerefItr(), hulls, bSort, thrNum, part);
 		currCnt = _count(results);
 
 		if (results.empty()) return {};
 		else if (results.size() == 1) return std::move(results.front());
-		//timer.pause();//####
 	}
-	//timer.resume();//####
+
+	//sub-hulls of a round are polygons in 2 dimensionality
+	if (action == R_MERGE) return _reduce(results, thrNum);
+
 	auto nextStep = _flatten(results, currCnt);
-	return sequential(timer, nextStep.begin(), nextStep.end(), getRefFromPtItr, bSort);
+	Hull& hull = hulls.front();
+	hull.reset(currCnt);
+	return _sequential<Vec>(nextStep.begin(), nextStep.end(), DerefItr(), hull, bSort, thrNum);
+}
+
+template <typename Tr>
+template <typename Itr, typename GetRef>
+typename ParalHullT<Tr>::ret_type ParalHullT<Tr>::specuParal(Timer& /*timer*/, Itr beg, Itr end, GetRef getRef, int thrNum)
+{
+	int size = end - beg;
+	thrNum = _thrNum(thrNum);
+
+	PointRefVec refs;
+	refs.reserve(size);
+	for (Itr itr = beg; itr != end; ++itr)
+	{
+		refs.push_back(getRef(itr));
+	}
+
+	Hull& hull = _pool(1).front();
+	hull.reset(size);
+	hull.insertSpeculative(refs, thrNum, thrNum * SPECU_BATCH);
+	return getPts(NDim == 2 ? hull.getPolygon() : hull.getPeaks());
+}
+
+template <typename Tr>
+template <typename Itr, typename GetRef>
+typename ParalHullT<Tr>::ret_type ParalHullT<Tr>::mergeParal(Timer& timer, Itr beg, Itr end, GetRef getRef, bool bSort, int thrNum, Partition part)
+{
+	thrNum = _thrNum(thrNum);
+	if (NDim != 2)
+	{
+		return manualParal(timer, beg, end, getRef, bSort, thrNum, part,
+			[](const RoundInfo&){return R_SEQUENTIAL;});
+	}
+
+	auto results = _parallel<PointRefVec>(beg, end, getRef, _pool(thrNum), bSort, thrNum, part);
+
+	if (results.empty()) return {};
+	return getPts(_reduce(results, thrNum));
+}
+
+template <typename Tr>
+template <typename Itr, typename GetRef>
+typename ParalHullT<Tr>::ret_type ParalHullT<Tr>::monotoneChain(Timer& /*timer*/, Itr beg, Itr end, GetRef getRef, int thrNum)
+{
+	assert(NDim == 2);
+	const int size = end - beg;
+	thrNum = _thrNum(thrNum);
+
+	PointRefVec refs(size);
+	#pragma omp parallel for schedule(static) shared(refs) num_threads(thrNum)
+	for (int i = 0; i < size; ++i)
+	{
+		refs[i] = getRef(beg + i);
+	}
+
+	ParalSort::mergesort(refs.begin(), refs.end(), thrNum,
+		[](PointRef a, PointRef b){return Polygon::less(*a, *b);});
+
+	while (size < thrNum * MIN_SIZE && thrNum > 1)
+	{
+		thrNum /= 2;
+	}
+
+	//blocks are x-ordered, so are their sorted hull vertices when concatenated
+	std::vector<PointRefVec> blocks(thrNum);
+	#pragma omp parallel for schedule(static) shared(refs, blocks) num_threads(thrNum)
+	for (int b = 0; b < thrNum; ++b)
+	{
+		PointRefVec block(refs.begin() + (long)size * b / thrNum, refs.begin() + (long)size * (b + 1) / thrNum);
+		blocks[b] = Polygon::sorted(Polygon::chain(block));
+	}
+
+	return getPts(Polygon::chain(_flatten(blocks)));
+}
+
+template <typename Tr>
+template <typename Itr, typename GetRef>
+typename ParalHullT<Tr>::ret_type ParalHullT<Tr>::quickHull(Timer& /*timer*/, Itr beg, Itr end, GetRef getRef, int thrNum)
+{
+	assert(NDim == 2);
+	const int size = end - beg;
+	thrNum = _thrNum(thrNum);
+	if (size == 0) return {};
+
+	PointRefVec refs(size);
+	int lo = 0, hi = 0;
+	#pragma omp parallel shared(refs, lo, hi) num_threads(thrNum)
+	{
+		int localLo = 0, localHi = 0;
+		#pragma omp for schedule(static)
+		for (int i = 0; i < size; ++i)
+		{
+			refs[i] = getRef(beg + i);
+		}
+		#pragma omp for schedule(static)
+		for (int i = 0; i < size; ++i)
+		{
+			if (Polygon::less(*refs[i], *refs[localLo])) localLo = i;
+			if (Polygon::less(*refs[localHi], *refs[i])) localHi = i;
+		}
+		#pragma omp critical
+		{
+			if (Polygon::less(*refs[localLo], *refs[lo])) lo = localLo;
+			if (Polygon::less(*refs[hi], *refs[localHi])) hi = localHi;
+		}
+	}
+
+	PointRef a = refs[lo], b = refs[hi];
+	if (*a == *b) return getPts({a});
+
+	//upper points are left of a->b, lower points are left of b->a
+	PointRefVec upper, lower, res;
+	#pragma omp parallel num_threads(thrNum)
+	#pragma omp single
+	{
+		_quickSplit(a, nullptr, b, refs, upper, lower);
+		PointRefVec().swap(refs);
+
+		PointRefVec upperRes, lowerRes;
+		#pragma omp task shared(upper, upperRes)
+		_quickHull(a, b, upper, upperRes);
+		_quickHull(b, a, lower, lowerRes);
+		#pragma omp taskwait
+
+		res.reserve(upperRes.size() + lowerRes.size() + 2);
+		res.push_back(a);
+		res.insert(res.end(), upperRes.begin(), upperRes.end());
+		res.push_back(b);
+		res.insert(res.end(), lowerRes.begin(), lowerRes.end());
+	}
+
+	//a farthest point picked by rounded distances may not be extreme, the
+	//exact chain over the few candidates drops it
+	std::sort(res.begin(), res.end(), [](PointRef p, PointRef q){return Polygon::less(*p, *q);});
+	return getPts(Polygon::chain(res));
+}
+
+template <typename Tr>
+template <typename Itr, typename GetRef>
+typename ParalHullT<Tr>::ret_type ParalHullT<Tr>::chan(Timer& /*timer*/, Itr beg, Itr end, GetRef getRef, int thrNum)
+{
+	assert(NDim == 2);
+	thrNum = _thrNum(thrNum);
+	if (beg == end) return {};
+
+	//points inside the extremes octagon are on no mini-hull
+	PointRefVec refs = prefilter(beg, end, getRef, 8, thrNum);
+
+	std::vector<Hull>& hulls = _pool(thrNum);
+	PointRefVec res;
+	const long m0 = std::max((long)CHAN_GROUP, ((long)refs.size() + thrNum - 1) / thrNum);
+	for (long m = m0; ; m = m * m)
+	{
+		const int size = refs.size();
+		m = std::max(std::min(m, (long)size), 1L);
+		const int nGroup = (size + m - 1) / m;
+		std::vector<PointRefVec> polys(nGroup);
+
+		#pragma omp parallel for schedule(dynamic, 1) shared(polys, hulls, refs) num_threads(thrNum)
+		for (int g = 0; g < nGroup; ++g)
+		{
+			Hull& hull = hulls[omp_get_thread_num()];
+			const int first = g * m, last = std::min(first + (int)m, size);
+			PointRefVec group(refs.begin() + first, refs.begin() + last);
+			hull.reset(group.size());
+			hull.insert(group);
+			polys[g] = hull.getPolygon();
+		}
+
+		res.clear();
+		if (nGroup == 1)
+		{
+			res = std::move(polys.front());
+			break;
+		}
+		if (_wrap(polys, m, thrNum, res)) break;
+
+		//hull vertices are mini-hull vertices, so later rounds group only those
+		refs = _flatten(polys);
+	}
+
+	return getPts(res);
+}
+
+template <typename Tr>
+template <typename Itr, typename GetRef>
+typename ParalHullT<Tr>::PointVec ParalHullT<Tr>::_extremes(Itr beg, Itr end, GetRef getRef, int nDir, int thrNum)
+{
+	//directions in counter-clockwise order, so are their extreme points
+	const auto& dirs = s_dirs;
+
+	const int size = end - beg;
+	const int step = 8 / nDir;
+
+	//dot products of the extreme points are kept beside them, so a point
+	//costs one dot product per direction
+	std::vector<PointRef> extremes(thrNum * nDir, nullptr);
+	std::vector<double> dots(thrNum * nDir, -std::numeric_limits<double>::infinity());
+	#pragma omp parallel shared(extremes, dots) num_threads(thrNum)
+	{
+		PointRef* local = &extremes[omp_get_thread_num() * nDir];
+		double* best = &dots[omp_get_thread_num() * nDir];
+		#pragma omp for schedule(static)
+		for (int i = 0; i < size; ++i)
+		{
+			PointRef p = getRef(beg + i);
+			const double x = (*p)[0], y = (*p)[1];
+			for (int k = 0; k < nDir; ++k)
+			{
+				const double* d = dirs[k * step];
+				const double dot = d[0] * x + d[1] * y;
+				if (!local[k] || dot > best[k])
+				{
+					local[k] = p;
+					best[k] = dot;
+				}
+			}
+		}
+	}
+
+	PointVec poly;
+	for (int k = 0; k < nDir; ++k)
+	{
+		const double* d = dirs[k * step];
+		PointRef best = nullptr;
+		for (int tid = 0; tid < thrNum; ++tid)
+		{
+			PointRef p = extremes[tid * nDir + k];
+			if (p && (!best || d[0] * (*p)[0] + d[1] * (*p)[1] > d[0] * (*best)[0] + d[1] * (*best)[1]))
+				best = p;
+		}
+		if (best && (poly.empty() || (poly.back() != *best && poly.front() != *best)))
+			poly.push_back(*best);
+	}
+
+	return poly;
+}
+
+template <typename Tr>
+template <typename Itr, typename GetRef>
+typename ParalHullT<Tr>::PointRefVec ParalHullT<Tr>::prefilter(Itr beg, Itr end, GetRef getRef, int nDir, int thrNum, FilterStats* stats)
+{
+	assert(nDir == 4 || nDir == 8);
+
+	const int size = end - beg;
+	thrNum = _thrNum(thrNum);
+
+	Timer t;
+	t.start();
+
+	PointVec poly;
+	if (NDim == 2) poly = _extremes(beg, end, getRef, nDir, thrNum);
+
+	int extremeCost = t.stop();
+	t.start();
+
+	PointRefVec res;
+	const int nEdge = poly.size();
+
+	if (nEdge < 3)
+	{//degenerate or no polygon, nothing is strictly inside
+		res.reserve(size);
+		for (Itr itr = beg; itr != end; ++itr) res.push_back(getRef(itr));
+	}
+	else
+	{
+		typename Visibility::Facets facets = _edgeFacets(poly);
+		std::vector<int> counts(thrNum + 1, 0);
+
+		#pragma omp parallel shared(counts, res, facets) num_threads(thrNum)
+		{
+			const int tid = omp_get_thread_num(), nThr = omp_get_num_threads();
+			const int first = (long)size * tid / nThr, last = (long)size * (tid + 1) / nThr;
+
+			//refs are gathered into FILTER_BLOCK coordinate arrays for the
+			//batch test, survivors are collected per thread in input order
+			PointRefVec local;
+			std::vector<Val_t> coords[NDim];
+			const Val_t* block[NDim];
+			for (int d = 0; d < NDim; ++d)
+			{
+				coords[d].resize(FILTER_BLOCK);
+				block[d] = coords[d].data();
+			}
+			uint64_t mask[(FILTER_BLOCK + 63) / 64];
+
+			for (int i = first; i < last; i += FILTER_BLOCK)
+			{
+				const int count = std::min(FILTER_BLOCK, last - i);
+				for (int j = 0; j < count; ++j)
+				{
+					const Point& p = *getRef(beg + i + j);
+					for (int d = 0; d < NDim; ++d) coords[d][j] = p[d];
+				}
+				Visibility::outside(block, count, facets, mask);
+				for (int j = 0; j < count; ++j)
+				{
+					if (mask[j / 64] >> (j % 64) & 1) local.push_back(getRef(beg + i + j));
+				}
+			}
+			counts[tid + 1] = local.size();
+
+			#pragma omp barrier
+			#pragma omp single
+			{
+				for (int i = 0; i < nThr; ++i) counts[i + 1] += counts[i];
+				res.resize(counts[nThr]);
+			}
+
+			std::copy(local.begin(), local.end(), res.begin() + counts[tid]);
+		}
+	}
+
+	if (stats)
+	{
+		stats->extreme = extremeCost;
+		stats->filter = t.stop();
+		stats->survivors = res.size();
+	}
+	return res;
+}
+
+template <typename Tr>
+template <typename Itr, typename GetRef>
+typename ParalHullT<Tr>::ret_type ParalHullT<Tr>::sequentialWithFilter(Timer& timer, Itr beg, Itr end, GetRef getRef, int nDir, int thrNum, FilterStats* stats)
+{
+	auto getRefFromRefItr = [](typename PointRefVec::iterator itr){return *itr;};
+	auto survivors = prefilter(beg, end, getRef, nDir, thrNum, stats);
+
+	Timer t;
+	t.start();
+	auto res = sequential(timer, survivors.begin(), survivors.end(), getRefFromRefItr, false, thrNum);
+	if (stats) stats->hull = t.stop();
+	return res;
+}
+
+template <typename Tr>
+template <typename Itr, typename GetRef>
+typename ParalHullT<Tr>::ret_type ParalHullT<Tr>::manualParalWithFilter(Timer& timer, Itr beg, Itr end, GetRef getRef, int nDir, int thrNum, FilterStats* stats)
+{
+	auto getRefFromRefItr = [](typename PointRefVec::iterator itr){return *itr;};
+	auto survivors = prefilter(beg, end, getRef, nDir, thrNum, stats);
+
+	Timer t;
+	t.start();
+	auto res = manualParal(timer, survivors.begin(), survivors.end(), getRefFromRefItr, false, thrNum);
+	if (stats) stats->hull = t.stop();
+	return res;
 }
 
+template <typename Tr>
 template <typename Itr, typename GetRef>
-ParalHull::ret_type ParalHull::manualParalWithPresort(Timer& timer, Itr beg, Itr end, GetRef getRef)
+typename ParalHullT<Tr>::ret_type ParalHullT<Tr>::manualParalWithPresort(Timer& timer, Itr beg, Itr end, GetRef getRef, int thrNum)
 {
-	return manualParal(timer, beg, end, getRef, true);
+	return manualParal(timer, beg, end, getRef, true, thrNum);
 }
 
 #endif
\ No newline at end of file
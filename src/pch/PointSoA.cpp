@@ -0,0 +1,100 @@
+//
+//  PointSoA.cpp
+//
+//	by Jiahuan.Liu
+//	jiahaun.liu@outlook.com
+//
+//  03/20/2017
+//
+
+#include <omp.h>
+
+#include "PointSoA.h"
+
+template <typename Tr>
+typename PointSoAT<Tr>::Point PointSoAT<Tr>::View::point(int i) const
+{
+	Point p;
+	for (int d = 0; d < NDim; ++d)
+	{
+		p[d] = c[d][i];
+	}
+	return p;
+}
+
+template <typename Tr>
+typename PointSoAT<Tr>::View PointSoAT<Tr>::View::sub(int first, int last) const
+{
+	View v;
+	for (int d = 0; d < NDim; ++d)
+	{
+		v.c[d] = c[d] + first;
+	}
+	v.n = last - first;
+	return v;
+}
+
+template <typename Tr>
+PointSoAT<Tr>::PointSoAT(int num)
+{
+	resize(num);
+}
+
+template <typename Tr>
+PointSoAT<Tr>::PointSoAT(const PointVec& points, int thrNum)
+{
+	const int size = points.size();
+	resize(size);
+
+	#pragma omp parallel for schedule(static) shared(points) num_threads(thrNum)
+	for (int i = 0; i < size; ++i)
+	{
+		for (int d = 0; d < NDim; ++d)
+		{
+			_c[d][i] = points[i][d];
+		}
+	}
+}
+
+template <typename Tr>
+typename PointSoAT<Tr>::PointVec PointSoAT<Tr>::toPoints(int thrNum) const
+{
+	const int num = size();
+	PointVec res;
+	res.resize(num); //PointVec(int) would generate random points
+
+	#pragma omp parallel for schedule(static) shared(res) num_threads(thrNum)
+	for (int i = 0; i < num; ++i)
+	{
+		for (int d = 0; d < NDim; ++d)
+		{
+			res[i][d] = _c[d][i];
+		}
+	}
+	return res;
+}
+
+template <typename Tr>
+void PointSoAT<Tr>::resize(int num)
+{
+	for (int d = 0; d < NDim; ++d)
+	{
+		_c[d].resize(num);
+	}
+}
+
+template <typename Tr>
+typename PointSoAT<Tr>::View PointSoAT<Tr>::view(int first, int last) const
+{
+	View v;
+	for (int d = 0; d < NDim; ++d)
+	{
+		v.c[d] = _c[d].data() + first;
+	}
+	v.n = last - first;
+	return v;
+}
+
+template class PointSoAT<Traits>;
+template class PointSoAT<TraitsF>;
+template class PointSoAT<Traits3>;
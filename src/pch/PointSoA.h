@@ -0,0 +1,106 @@
+//
+//  PointSoA.h
+//
+//	@brief: structure-of-arrays point container, one aligned array per
+//			coordinate, with zero-copy views over ranges of it
+//
+//	by Jiahuan.Liu
+//	jiahaun.liu@outlook.com
+//
+//  03/20/2017
+//
+
+#ifndef _POINTSOA_H
+#define _POINTSOA_H
+
+#include <vector>
+#include <stdlib.h>
+#include <new>
+
+#include "Points.h"
+
+const int SOA_ALIGN = 32; //one AVX register
+
+template <typename T, size_t Align>
+struct AlignedAllocator
+{
+	using value_type = T;
+	template <typename U> struct rebind {using other = AlignedAllocator<U, Align>;};
+
+	AlignedAllocator() {}
+	template <typename U> AlignedAllocator(const AlignedAllocator<U, Align>&) {}
+
+	T* allocate(size_t n)
+	{
+		void* p = nullptr;
+		if (posix_memalign(&p, Align, n * sizeof(T))) throw std::bad_alloc();
+		return (T*)p;
+	}
+	void deallocate(T* p, size_t) {free(p);}
+
+	bool operator== (const AlignedAllocator&) const {return true;}
+	bool operator!= (const AlignedAllocator&) const {return false;}
+};
+
+template <typename Tr>
+class PointSoAT
+{
+public:
+	static const int NDim = Tr::NDim;
+	using Val_t = typename Tr::Scalar;
+	using Point = typename Tr::Point;
+	using PointVec = PointVecT<Tr>;
+	using Array = std::vector<Val_t, AlignedAllocator<Val_t, SOA_ALIGN>>;
+
+	//
+	// @brief: zero-copy view of points [first, first + size) of a PointSoAT,
+	// 		   valid while the container is not resized
+	//
+	struct View
+	{
+		const Val_t* c[NDim];
+		int n;
+
+		int size() const {return n;}
+		const Val_t* coord(int d) const {return c[d];}
+		const Val_t* const* coords() const {return c;}
+		Point point(int i) const;
+		View sub(int first, int last) const;
+	};
+
+public:
+	PointSoAT() {}
+
+	PointSoAT(int num);
+
+	//
+	// @brief: convert from points, thrNum threads fill the arrays
+	//
+	PointSoAT(const PointVec& points, int thrNum = 1);
+
+	//
+	// @brief: convert back to points, thrNum threads fill the vector
+	//
+	PointVec toPoints(int thrNum = 1) const;
+
+	int size() const {return _c[0].size();}
+	void resize(int num);
+
+	Val_t* coord(int d) {return _c[d].data();}
+	const Val_t* coord(int d) const {return _c[d].data();}
+
+	Point point(int i) const {return view().point(i);}
+
+	View view() const {return view(0, size());}
+	View view(int first, int last) const;
+
+private:
+	Array _c[NDim];
+};
+
+template <typename Tr> const int PointSoAT<Tr>::NDim;
+
+typedef PointSoAT<Traits> PointSoA;
+typedef PointSoAT<Traits3> PointSoA3;
+
+#endif
@@ -8,13 +8,15 @@
 //
 
 #include <numeric>
+#include <cmath>
 
 #include "Points.h"
 
 const int g_scale = 1e6;
 const int g_range = g_scale / 2;
 
-PointVec::PointVec(int num)
+template <typename Tr>
+PointVecT<Tr>::PointVecT(int num)
 {
 	base_t::reserve(num);
 	while (num--)
@@ -23,41 +25,135 @@ PointVec::PointVec(int num)
 	}
 }
 
-PointVec::val_t PointVec::rand()
+template <typename Tr>
+typename PointVecT<Tr>::val_t PointVecT<Tr>::rand()
 {
 	return (val_t)(((long)::rand() % g_scale) - g_range) / 1e3;
 }
 
-void PointVec::random()
+template <typename Tr>
+PointVecT<Tr>::PointVecT(int num, Dist dist)
 {
-	base_t::emplace_back(rand(), rand());
+	base_t::reserve(num);
+	while (num--)
+	{
+		random(dist);
+	}
+}
+
+template <typename Tr>
+typename PointVecT<Tr>::val_t PointVecT<Tr>::_gauss()
+{//box-muller
+	const val_t u = ((val_t)::rand() + 1) / ((val_t)RAND_MAX + 2);
+	const val_t v = (val_t)::rand() / RAND_MAX;
+	return std::sqrt(-2 * std::log(u)) * std::cos(2 * M_PI * v);
+}
+
+template <typename Tr>
+void PointVecT<Tr>::random()
+{
+	point_t p;
+	for (int d = 0; d < NDim; ++d)
+	{
+		p[d] = rand();
+	}
+	base_t::push_back(p);
+}
+
+template <typename Tr>
+void PointVecT<Tr>::random(Dist dist)
+{
+	const val_t range = g_range / 1e3;
+	const int nCluster = 8;
+
+	point_t p;
+	switch (dist)
+	{
+	case CLUSTER:
+	{
+		//cluster centers are fixed by the cluster id, jitter by box-muller
+		const int c = ::rand() % nCluster;
+		p.fill(0);
+		p[0] = range * std::cos(2 * M_PI * c / nCluster) / 2;
+		p[1] = range * std::sin(2 * M_PI * c / nCluster) / 2;
+		if (NDim == 2)
+		{
+			const val_t u = ((val_t)::rand() + 1) / ((val_t)RAND_MAX + 2);
+			const val_t v = (val_t)::rand() / RAND_MAX;
+			const val_t r = range / 32 * std::sqrt(-2 * std::log(u));
+			p[0] += r * std::cos(2 * M_PI * v);
+			p[1] += r * std::sin(2 * M_PI * v);
+		}
+		else
+		{
+			for (int d = 0; d < NDim; ++d)
+			{
+				p[d] += range / 32 * _gauss();
+			}
+		}
+		break;
+	}
+	case CIRCLE:
+	{
+		if (NDim == 2)
+		{
+			const val_t a = 2 * M_PI * ((long)::rand() % g_scale) / g_scale;
+			const val_t r = range * std::sqrt((val_t)((long)::rand() % g_scale) / g_scale);
+			p[0] = r * std::cos(a);
+			p[1] = r * std::sin(a);
+		}
+		else
+		{//a ball by rejection from the cube
+			do
+			{
+				for (int d = 0; d < NDim; ++d)
+				{
+					p[d] = rand();
+				}
+			} while (p.squaredNorm() > range * range);
+		}
+		break;
+	}
+	default:
+		random();
+		return;
+	}
+	base_t::push_back(p);
 }
 
-void PointVec::initRand(long seed) 
+template <typename Tr>
+void PointVecT<Tr>::initRand(long seed) 
 {
 	srand((unsigned int)seed);
 }
 
-bool PointVec::operator== (const PointVec& pv) const
+template <typename Tr>
+bool PointVecT<Tr>::operator== (const PointVecT& pv) const
 {
 	if (this->size() != pv.size()) return false;
-	PointHashSet s(this->begin(), this->end());
-	return std::accumulate(pv.begin(), pv.end(), true, [&s](bool res, const Point& p)
+	std::unordered_set<point_t> s(this->begin(), this->end());
+	return std::accumulate(pv.begin(), pv.end(), true, [&s](bool res, const point_t& p)
 		{return res & (s.find(p) != s.end());});
 }
 
-bool PointVec::operator!= (const PointVec& pv) const
+template <typename Tr>
+bool PointVecT<Tr>::operator!= (const PointVecT& pv) const
 {
 	return !((*this) == pv);
 }
 
-double PointVec::jaccard (const PointVec& pv) const
+template <typename Tr>
+double PointVecT<Tr>::jaccard (const PointVecT& pv) const
 {
-	PointHashSet s_or(this->begin(), this->end()),
+	std::unordered_set<point_t> s_or(this->begin(), this->end()),
 		s_and = s_or;
-	for (const Point& p : pv)
+	for (const point_t& p : pv)
 		if (s_or.find(p) != s_or.end())
 			s_and.insert(p);
 	s_or.insert(pv.begin(), pv.end());
 	return (double)s_and.size() / s_or.size();
-}
\ No newline at end of file
+}
+
+template class PointVecT<Traits>;
+template class PointVecT<TraitsF>;
+template class PointVecT<Traits3>;
@@ -22,48 +22,81 @@ using namespace mpblocks::clarkson93;
 #define MAX_NUM 1000
 
 typedef double Val_t;
-#define NDim 2
+const int NDim = 2; //dimensionality of Traits, templates use Tr::NDim
 typedef ExampleTraits2<Val_t, NDim>     Traits;
+typedef ExampleTraits2<float, NDim>     TraitsF; //half the footprint of Traits
+typedef ExampleTraits2<Val_t, 3>        Traits3; //point clouds
 typedef Triangulation<Traits>           Triangulation_t;
 typedef Triangulation_t::Point          Point;
 typedef Triangulation_t::PointRef       PointRef;
 typedef std::vector<PointRef>           PointRefVec;
 
-class PointVec: public std::vector<Point>
+template <typename Tr>
+class PointVecT: public std::vector<typename Tr::Point>
 {
-	using val_t = Val_t ;
-	using base_t = std::vector<Point>;
+	static const int NDim = Tr::NDim;
+	using val_t = typename Tr::Scalar;
+	using point_t = typename Tr::Point;
+	using base_t = std::vector<point_t>;
 
 public:
-	PointVec() {}
+	//
+	// @brief: distribution of generated points
+	//
+	enum Dist
+	{
+		UNIFORM,	//uniform in a square, or a cube
+		CLUSTER,	//a few dense gaussian clusters
+		CIRCLE		//uniform in a disk, or a ball, hull is denser than a square's
+	};
+
+	PointVecT() {}
+
+	PointVecT(int num);
 
-	PointVec(int num);
+	PointVecT(int num, Dist dist);
 
 	void random();
 
+	void random(Dist dist);
+
 	static void initRand(long seed = time(NULL));
 
-	bool operator== (const PointVec& pv) const;
+	bool operator== (const PointVecT& pv) const;
 
-	bool operator!= (const PointVec& pv) const;
+	bool operator!= (const PointVecT& pv) const;
 
-	double jaccard (const PointVec& pv) const;
+	double jaccard (const PointVecT& pv) const;
 
 	static val_t rand();
+
+private:
+	static val_t _gauss();
 };
 
+template <typename Tr> const int PointVecT<Tr>::NDim;
+
+typedef PointVecT<Traits>	PointVec;
+typedef PointVecT<TraitsF>	PointVecF;
+typedef PointVecT<Traits3>	PointVec3;
+
 typedef std::size_t hash_t;
 typedef std::unordered_set<Point> PointHashSet;
 typedef std::unordered_set<PointRef> PointRefHashSet;
 
 namespace std
 {
-	template <> struct hash<Point>
+	template <typename S, int D> struct hash<Eigen::Matrix<S, D, 1>>
 	{
-		hash_t operator()(const Point & p) const
+		hash_t operator()(const Eigen::Matrix<S, D, 1> & p) const
 		{
-			return std::hash<Val_t>{}(p[0]) ^
-				(std::hash<Val_t>{}(p[1]) << (sizeof(hash_t) / 2 * 8));
+			hash_t h = std::hash<S>{}(p[0]) ^
+				(std::hash<S>{}(p[1]) << (sizeof(hash_t) / 2 * 8));
+			for (int d = 2; d < D; ++d)
+			{
+				h ^= std::hash<S>{}(p[d]) + 0x9e3779b9 + (h << 6) + (h >> 2);
+			}
+			return h;
 		}
 	};
 }
@@ -0,0 +1,218 @@
+//
+//  Polygon.h
+//
+//	@brief: convex polygon operations in 2 dimensionality
+//
+//	by Jiahuan.Liu
+//	jiahaun.liu@outlook.com
+//
+//  03/14/2017
+//
+
+#ifndef _POLYGON_H
+#define _POLYGON_H
+
+#include <vector>
+#include <algorithm>
+#include <iterator>
+
+#include "Points.h"
+
+class Polygon
+{
+public:
+	//
+	// @brief: twice the signed area of triangle (o, a, b)
+	// @return: > 0 if o->a->b turns left
+	//
+	template <typename P>
+	static typename P::Scalar cross(const P& o, const P& a, const P& b);
+
+	//
+	// @brief: exact sign of cross, see clarkson93::predicates::orient2d
+	//
+	template <typename P>
+	static int turn(const P& o, const P& a, const P& b) {return predicates::orient2d(o, a, b);}
+
+	//
+	// @brief: lexicographic order, x then y
+	//
+	template <typename P>
+	static bool less(const P& a, const P& b);
+
+	template <typename P>
+	static const P& pt(const P& p) {return p;}
+	template <typename P>
+	static const P& pt(P* ref) {return *ref;}
+
+	//
+	// @brief: make polygon vertices counter-clockwise
+	//
+	template <typename Vec>
+	static void orient(Vec& poly);
+
+	//
+	// @brief: drop vertices where a convex polygon runs straight, so every
+	// 		   engine reports the same strictly convex vertex set
+	//
+	template <typename Vec>
+	static void strict(Vec& poly);
+
+	//
+	// @brief: vertices of a counter-clockwise convex polygon in
+	// 		   lexicographic order, in O(h) by merging its two chains
+	//
+	template <typename Vec>
+	static Vec sorted(const Vec& poly);
+
+	//
+	// @brief: monotone chain over lexicographically sorted points
+	// @return: counter-clockwise convex polygon, collinear points dropped
+	//
+	template <typename Vec>
+	static Vec chain(const Vec& sorted);
+
+	//
+	// @brief: merge two counter-clockwise convex polygons in O(h)
+	//
+	template <typename Vec>
+	static Vec merge(const Vec& poly0, const Vec& poly1);
+
+	//
+	// @brief: whether p is strictly inside a counter-clockwise convex
+	// 		   polygon, in O(log h) by binary search over the fan of poly[0]
+	//
+	template <typename Vec, typename P>
+	static bool inside(const Vec& poly, const P& p);
+};
+
+template <typename P>
+typename P::Scalar Polygon::cross(const P& o, const P& a, const P& b)
+{
+	return (a[0] - o[0]) * (b[1] - o[1]) - (a[1] - o[1]) * (b[0] - o[0]);
+}
+
+template <typename P>
+bool Polygon::less(const P& a, const P& b)
+{
+	return a[0] < b[0] || (a[0] == b[0] && a[1] < b[1]);
+}
+
+template <typename Vec>
+void Polygon::orient(Vec& poly)
+{
+	double area = 0;
+	for (int i = 0, n = poly.size(); i < n; ++i)
+	{
+		const auto& a = pt(poly[i]);
+		const auto& b = pt(poly[(i + 1) % n]);
+		area += a[0] * b[1] - a[1] * b[0];
+	}
+	if (area < 0)
+	{
+		std::reverse(poly.begin(), poly.end());
+	}
+}
+
+template <typename Vec>
+void Polygon::strict(Vec& poly)
+{
+	const int n = poly.size();
+	if (n < 3) return;
+
+	Vec res;
+	res.reserve(n);
+	for (int i = 0; i < n; ++i)
+	{
+		if (turn(pt(poly[(i + n - 1) % n]), pt(poly[i]), pt(poly[(i + 1) % n])) != 0) res.push_back(poly[i]);
+	}
+	poly.swap(res);
+}
+
+template <typename Vec>
+Vec Polygon::sorted(const Vec& poly)
+{
+	const int n = poly.size();
+	if (n == 0) return {};
+
+	int lo = 0, hi = 0;
+	for (int i = 1; i < n; ++i)
+	{
+		if (less(pt(poly[i]), pt(poly[lo]))) lo = i;
+		if (less(pt(poly[hi]), pt(poly[i]))) hi = i;
+	}
+
+	//lower chain runs lo->hi, upper chain runs hi->lo, both counter-clockwise
+	Vec lower, upper;
+	for (int i = lo; ; i = (i + 1) % n)
+	{
+		lower.push_back(poly[i]);
+		if (i == hi) break;
+	}
+	for (int i = (lo + n - 1) % n; i != hi; i = (i + n - 1) % n)
+	{
+		upper.push_back(poly[i]);
+	}
+
+	Vec res;
+	res.reserve(n);
+	auto comp = [](const typename Vec::value_type& a, const typename Vec::value_type& b)
+		{return less(pt(a), pt(b));};
+	std::merge(lower.begin(), lower.end(), upper.begin(), upper.end(), std::back_inserter(res), comp);
+	return res;
+}
+
+template <typename Vec>
+Vec Polygon::chain(const Vec& sorted)
+{
+	const int n = sorted.size();
+	if (n < 3) return sorted;
+
+	Vec res;
+	res.resize(2 * n); //PointVec(int) would generate random points
+	int k = 0;
+	for (int i = 0; i < n; ++i)
+	{//lower chain
+		while (k >= 2 && turn(pt(res[k - 2]), pt(res[k - 1]), pt(sorted[i])) <= 0) --k;
+		res[k++] = sorted[i];
+	}
+	for (int i = n - 2, t = k + 1; i >= 0; --i)
+	{//upper chain
+		while (k >= t && turn(pt(res[k - 2]), pt(res[k - 1]), pt(sorted[i])) <= 0) --k;
+		res[k++] = sorted[i];
+	}
+	res.resize(k - 1);
+	return res;
+}
+
+template <typename Vec>
+Vec Polygon::merge(const Vec& poly0, const Vec& poly1)
+{
+	Vec s0 = sorted(poly0), s1 = sorted(poly1), all;
+	all.reserve(s0.size() + s1.size());
+	auto comp = [](const typename Vec::value_type& a, const typename Vec::value_type& b)
+		{return less(pt(a), pt(b));};
+	std::merge(s0.begin(), s0.end(), s1.begin(), s1.end(), std::back_inserter(all), comp);
+	return chain(all);
+}
+
+template <typename Vec, typename P>
+bool Polygon::inside(const Vec& poly, const P& p)
+{
+	const int n = poly.size();
+	if (n < 3) return false;
+
+	const P& o = pt(poly[0]);
+	if (turn(o, pt(poly[1]), p) <= 0 || turn(o, pt(poly[n - 1]), p) >= 0) return false;
+
+	int lo = 1, hi = n - 1;
+	while (hi - lo > 1)
+	{
+		int mid = (lo + hi) / 2;
+		if (turn(o, pt(poly[mid]), p) > 0) lo = mid;
+		else hi = mid;
+	}
+	return turn(pt(poly[lo]), pt(poly[hi]), p) > 0;
+}
+
+#endif
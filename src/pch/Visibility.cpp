@@ -0,0 +1,132 @@
+//
+//  Visibility.cpp
+//
+//	by Jiahuan.Liu
+//	jiahaun.liu@outlook.com
+//
+//  03/19/2017
+//
+
+#include <string.h>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define VISIBILITY_AVX2
+#include <immintrin.h>
+#endif
+
+#include "Visibility.h"
+
+template <typename Val, int Dim>
+void VisibilityT<Val, Dim>::Facets::clear()
+{
+	for (int d = 0; d < NDim; ++d)
+	{
+		n[d].clear();
+	}
+	o.clear();
+}
+
+#ifdef VISIBILITY_AVX2
+//
+// @brief: compiled for AVX2 whatever the build flags, only called when
+// 		   the cpu supports it
+// @return: number of leading points tested, the rest are left to _outside
+//
+template <int NDim>
+__attribute__((target("avx2")))
+static int outsideAvx(const double* const* coords, int count, const typename VisibilityT<double, NDim>::Facets& facets, uint64_t* mask)
+{
+	int first = 0;
+	const int nFacet = facets.size();
+	for (; first + 4 <= count; first += 4)
+	{
+		__m256d x[NDim];
+		for (int d = 0; d < NDim; ++d)
+		{
+			x[d] = _mm256_loadu_pd(coords[d] + first);
+		}
+
+		int bits = 0;
+		for (int f = 0; f < nFacet && bits != 0xF; ++f)
+		{
+			__m256d dot = _mm256_mul_pd(_mm256_set1_pd(facets.n[0][f]), x[0]);
+			for (int d = 1; d < NDim; ++d)
+			{
+				dot = _mm256_add_pd(dot, _mm256_mul_pd(_mm256_set1_pd(facets.n[d][f]), x[d]));
+			}
+			bits |= _mm256_movemask_pd(_mm256_cmp_pd(dot, _mm256_set1_pd(facets.o[f]), _CMP_LT_OQ));
+		}
+		mask[first / 64] |= (uint64_t)bits << (first % 64);
+	}
+	return first;
+}
+
+template <int NDim>
+__attribute__((target("avx2")))
+static int outsideAvx(const float* const* coords, int count, const typename VisibilityT<float, NDim>::Facets& facets, uint64_t* mask)
+{
+	int first = 0;
+	const int nFacet = facets.size();
+	for (; first + 8 <= count; first += 8)
+	{
+		__m256 x[NDim];
+		for (int d = 0; d < NDim; ++d)
+		{
+			x[d] = _mm256_loadu_ps(coords[d] + first);
+		}
+
+		int bits = 0;
+		for (int f = 0; f < nFacet && bits != 0xFF; ++f)
+		{
+			__m256 dot = _mm256_mul_ps(_mm256_set1_ps(facets.n[0][f]), x[0]);
+			for (int d = 1; d < NDim; ++d)
+			{
+				dot = _mm256_add_ps(dot, _mm256_mul_ps(_mm256_set1_ps(facets.n[d][f]), x[d]));
+			}
+			bits |= _mm256_movemask_ps(_mm256_cmp_ps(dot, _mm256_set1_ps(facets.o[f]), _CMP_LT_OQ));
+		}
+		mask[first / 64] |= (uint64_t)bits << (first % 64);
+	}
+	return first;
+}
+
+static bool hasAvx2()
+{
+	static const bool has = __builtin_cpu_supports("avx2");
+	return has;
+}
+#endif
+
+template <typename Val, int Dim>
+void VisibilityT<Val, Dim>::outside(const Val* const* coords, int count, const Facets& facets, uint64_t* mask)
+{
+	memset(mask, 0, (count + 63) / 64 * sizeof(uint64_t));
+	int first = 0;
+#ifdef VISIBILITY_AVX2
+	if (hasAvx2()) first = outsideAvx<Dim>(coords, count, facets, mask);
+#endif
+	_outside(coords, first, count, facets, mask);
+}
+
+template <typename Val, int Dim>
+void VisibilityT<Val, Dim>::_outside(const Val* const* coords, int first, int last, const Facets& facets, uint64_t* mask)
+{
+	const int nFacet = facets.size();
+	for (int i = first; i < last; ++i)
+	{
+		bool out = false;
+		for (int f = 0; f < nFacet && !out; ++f)
+		{
+			Val dot = 0;
+			for (int d = 0; d < NDim; ++d)
+			{
+				dot += facets.n[d][f] * coords[d][i];
+			}
+			out = dot < facets.o[f];
+		}
+		mask[i / 64] |= (uint64_t)out << (i % 64);
+	}
+}
+
+template class VisibilityT<double, 2>;
+template class VisibilityT<float, 2>;
+template class VisibilityT<double, 3>;
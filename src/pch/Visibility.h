@@ -0,0 +1,85 @@
+//
+//  Visibility.h
+//
+//	@brief: batch test of points against hull facets
+//
+//	by Jiahuan.Liu
+//	jiahaun.liu@outlook.com
+//
+//  03/19/2017
+//
+
+#ifndef _VISIBILITY_H
+#define _VISIBILITY_H
+
+#include <vector>
+#include <limits>
+#include <cmath>
+#include <stdint.h>
+
+#include "Points.h"
+
+const int FILTER_BLOCK = 256; //points tested per batch before insertion
+const int FILTER_FACETS = 64; //above this many facets, insertion walks are cheaper
+const int FILTER_EPS = 16; //facet offset margin in epsilons of the scalar type
+
+template <typename Val, int Dim>
+class VisibilityT
+{
+public:
+	static const int NDim = Dim;
+
+	//
+	// @brief: hull facets as structure of arrays, a point x sees facet f
+	// 		   if n[0][f] * x[0] + ... + n[NDim-1][f] * x[NDim-1] < o[f]
+	//
+	struct Facets
+	{
+		std::vector<Val> n[NDim];
+		std::vector<Val> o;
+
+		void clear();
+		int size() const {return o.size();}
+
+		//
+		// @brief: o is loosened by FILTER_EPS epsilons of Val relative to the
+		// 		   magnitude of the terms, so rounding apart from
+		// 		   SimplexOps::isVisible never drops a visible point
+		// @param: scale: magnitude of the facet vertex coordinates
+		//
+		template <typename Vec>
+		void push(const Vec& n, Val o, Val scale);
+	};
+
+	//
+	// @brief: bit i of mask is set if point i sees any facet, 4 doubles
+	// 		   or 8 floats at a time if the cpu has AVX2 (checked at run
+	// 		   time, no build flag needed), one at a time otherwise
+	// @param: coords: coords[d][i] is coordinate d of point i
+	// 		   mask: (count + 63) / 64 words
+	//
+	static void outside(const Val* const* coords, int count, const Facets& facets, uint64_t* mask);
+
+private:
+	static void _outside(const Val* const* coords, int first, int last, const Facets& facets, uint64_t* mask);
+};
+
+template <typename Val, int Dim> const int VisibilityT<Val, Dim>::NDim;
+
+typedef VisibilityT<Val_t, NDim> Visibility;
+
+template <typename Val, int Dim>
+template <typename Vec>
+void VisibilityT<Val, Dim>::Facets::push(const Vec& normal, Val offset, Val scale)
+{
+	Val norm = 0;
+	for (int d = 0; d < NDim; ++d)
+	{
+		n[d].push_back(normal[d]);
+		norm += std::abs(normal[d]);
+	}
+	const Val eps = FILTER_EPS * std::numeric_limits<Val>::epsilon();
+	o.push_back(offset + eps * (std::abs(offset) + norm * scale));
+}
+
+#endif
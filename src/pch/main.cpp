@@ -28,6 +28,11 @@ int main(int argc, char** argv)
 		// testUnitTest();
 		// testSort();
 		// testMarginalitySort();
+		// testPartition(4, 1000000);
+		// testTraits(4, 1000000);
+		// testBaseNormal();
+		// testInsertion(4, 100000);
+		// testFinish(4, 100000);
 	}
 	
 }
\ No newline at end of file
@@ -14,6 +14,7 @@
 #include <algorithm>
 #include <time.h>
 #include <functional>
+#include <map>
 
 #include "tests.h"
 
@@ -21,6 +22,20 @@
 #include "Marginality.h"
 #include "ParalHull.h"
 #include "ParalSort.h"
+#include "HullStream.h"
+#include "PointSoA.h"
+#include "AllocCount.h"
+
+//
+// @brief: allocations made by f
+//
+template <typename F>
+static long countAllocs(F f)
+{
+	AllocCount::start();
+	f();
+	return AllocCount::stop();
+}
 
 void testTimer()
 {
@@ -139,6 +154,57 @@ void testMarginalitySort()
 	auto res = Marginality::sort(test0.begin(), test0.end(), getRefFromPtItr);
 }
 
+//
+// @brief: time parallel engines over doubling thread numbers up to the
+// 		   engine default, checking each result against gt
+//
+static void reportScaling(PointVec& points, const PointVec& gt)
+{
+	auto getRefFromPtItr = [](PointVec::iterator itr){return &(*itr);};
+	Timer timer;
+
+	std::vector<int> thrNums;
+	for (int thrNum = 1; thrNum < ParalHull::getThrNum(); thrNum *= 2)
+		thrNums.push_back(thrNum);
+	thrNums.push_back(ParalHull::getThrNum());
+
+	std::cout << "------------------------------------\nscaling (threads: manualParal manualParalWithPresort specuParal mergeParal monotoneChain quickHull chan):\n";
+	for (int thrNum : thrNums)
+	{
+		timer.start();
+		bool r1 = ParalHull::manualParal(timer, points.begin(), points.end(), getRefFromPtItr, false, thrNum) == gt;
+		auto t1 = timer.stop();
+
+		timer.start();
+		bool r2 = ParalHull::manualParalWithPresort(timer, points.begin(), points.end(), getRefFromPtItr, thrNum) == gt;
+		auto t2 = timer.stop();
+
+		timer.start();
+		bool r3 = ParalHull::specuParal(timer, points.begin(), points.end(), getRefFromPtItr, thrNum) == gt;
+		auto t3 = timer.stop();
+
+		timer.start();
+		bool r4 = ParalHull::mergeParal(timer, points.begin(), points.end(), getRefFromPtItr, false, thrNum) == gt;
+		auto t4 = timer.stop();
+
+		timer.start();
+		bool r5 = ParalHull::monotoneChain(timer, points.begin(), points.end(), getRefFromPtItr, thrNum) == gt;
+		auto t5 = timer.stop();
+
+		timer.start();
+		bool r6 = ParalHull::quickHull(timer, points.begin(), points.end(), getRefFromPtItr, thrNum) == gt;
+		auto t6 = timer.stop();
+
+		timer.start();
+		bool r7 = ParalHull::chan(timer, points.begin(), points.end(), getRefFromPtItr, thrNum) == gt;
+		auto t7 = timer.stop();
+
+		std::cout << thrNum << ": " << t1 << " " << t2 << " " << t3 << " " << t4 << " " << t5 << " " << t6 << " " << t7;
+		if (!(r1 && r2 && r3 && r4 && r5 && r6 && r7)) std::cout << " (WA)";
+		std::cout << std::endl;
+	}
+}
+
 struct result_t
 {
 	int size;
@@ -146,8 +212,48 @@ struct result_t
 	unsigned long t2;
 	unsigned long t3;
 	unsigned long t4;
+	unsigned long t5;
+	unsigned long t6;
+	unsigned long t7;
+	unsigned long t8;
+	unsigned long t9;
 };
 
+//
+// @brief: allocations of inserting points into a warm hull, the hull is
+// 		   warmed by one full insertion, then reset and seeded, so the
+// 		   remaining inserts must reuse its simplices and scratch
+// @param: block: insert the rest as one vector instead of one by one
+// 		   thrNum: insert the rest speculatively with thrNum threads if > 0
+//
+template <typename H>
+static long steadyAllocs(H& hull, typename H::PointVec& points, bool block, int thrNum = 0)
+{
+	using PointRef = typename H::PointRef;
+	const int seed = 16;
+
+	std::vector<PointRef> refs;
+	for (auto& p : points) refs.push_back(&p);
+	std::vector<PointRef> rest(refs.begin() + seed, refs.end());
+
+	//warm both paths, the last round only seeds
+	for (int warm = 0; warm < 3; ++warm)
+	{
+		hull.reset(points.size());
+		for (int i = 0; i < seed; ++i) hull.insert(refs[i]);
+		if (thrNum > 0 && warm < 2) hull.insertSpeculative(rest, thrNum, thrNum * SPECU_BATCH);
+		else if (warm == 0) hull.insert(rest);
+		else if (warm == 1) for (PointRef r : rest) hull.insert(r);
+	}
+
+	return countAllocs([&]()
+	{
+		if (thrNum > 0) hull.insertSpeculative(rest, thrNum, thrNum * SPECU_BATCH);
+		else if (block) hull.insert(rest);
+		else for (PointRef r : rest) hull.insert(r);
+	});
+}
+
 void testAlg(int seed, int size, int loop)
 {
 	auto getRefFromRefItr = [](PointRefVec::iterator itr){return *itr;};
@@ -176,6 +282,62 @@ void testAlg(int seed, int size, int loop)
 	std::cout << "correctness: " << (ParalHull::manualParal(timer, test1.begin(), test1.end(), getRefFromPtItr) == gt) << ". time: ";
 	std::cout << timer.stop() << std::endl;
 
+	std::cout << "------------------------------------\nspecuParal:\n";
+	timer.start();
+	std::cout << "correctness: " << (ParalHull::specuParal(timer, test1.begin(), test1.end(), getRefFromPtItr) == gt) << ". time: ";
+	std::cout << timer.stop() << std::endl;
+
+	std::cout << "------------------------------------\nmergeParal:\n";
+	timer.start();
+	std::cout << "correctness: " << (ParalHull::mergeParal(timer, test1.begin(), test1.end(), getRefFromPtItr) == gt) << ". time: ";
+	std::cout << timer.stop() << std::endl;
+
+	std::cout << "------------------------------------\nmonotoneChain:\n";
+	timer.start();
+	std::cout << "correctness: " << (ParalHull::monotoneChain(timer, test1.begin(), test1.end(), getRefFromPtItr) == gt) << ". time: ";
+	std::cout << timer.stop() << std::endl;
+
+	std::cout << "------------------------------------\nquickHull:\n";
+	timer.start();
+	std::cout << "correctness: " << (ParalHull::quickHull(timer, test1.begin(), test1.end(), getRefFromPtItr) == gt) << ". time: ";
+	std::cout << timer.stop() << std::endl;
+
+	std::cout << "------------------------------------\nchan:\n";
+	timer.start();
+	std::cout << "correctness: " << (ParalHull::chan(timer, test1.begin(), test1.end(), getRefFromPtItr) == gt) << ". time: ";
+	std::cout << timer.stop() << std::endl;
+
+	std::cout << "------------------------------------\nchan vs sequential (small h, 1000000 uniform points, mean of 3):\n";
+	{
+		PointVec small(1000000, PointVec::UNIFORM);
+		auto gtSmall = ParalHull::sequential(timer, small.begin(), small.end(), getRefFromPtItr);
+		bool correct = true;
+		int seqCost = 0, chanCost = 0;
+		for (int i = 0; i < 3; ++i)
+		{
+			timer.start();
+			ParalHull::sequential(timer, small.begin(), small.end(), getRefFromPtItr);
+			seqCost += timer.stop();
+			timer.start();
+			correct &= ParalHull::chan(timer, small.begin(), small.end(), getRefFromPtItr) == gtSmall;
+			chanCost += timer.stop();
+		}
+		std::cout << "correctness: " << correct << ". h: " << gtSmall.size()
+			<< " sequential: " << seqCost / 3 << " chan: " << chanCost / 3 << std::endl;
+	}
+
+	std::cout << "------------------------------------\nmanualParalRefs:\n";
+	timer.start();
+	{
+		auto refs = ParalHull::manualParalRefs(timer, test1.begin(), test1.end(), getRefFromPtItr);
+		auto cost = timer.stop();
+		PointVec byIndex;
+		for (size_t idx : ParalHull::getIndices(refs, test1.data()))
+			byIndex.push_back(test1[idx]);
+		std::cout << "correctness: " << (ParalHull::getPts(refs) == gt && byIndex == gt) << ". time: ";
+		std::cout << cost << std::endl;
+	}
+
 	std::cout << "------------------------------------\nsequential:\n";
 	timer.start();
 	std::cout << "correctness: " << (ParalHull::sequential(timer, test1.begin(), test1.end(), getRefFromPtItr) == gt) << ". time: ";
@@ -188,9 +350,298 @@ void testAlg(int seed, int size, int loop)
 
 	std::cout << "------------------------------------\nsequential with presort:\n";
 	timer.start();
-	std::cout << "correctness: " << (ParalHull::sequential(timer, test1.begin(), test1.end(), getRefFromPtItr, true).jaccard(gt)) << ". time: ";
+	std::cout << "correctness: " << (ParalHull::sequential(timer, test1.begin(), test1.end(), getRefFromPtItr, true) == gt) << ". time: ";
+	std::cout << timer.stop() << std::endl;
+
+	std::cout << "------------------------------------\nsequential with brio:\n";
+	timer.start();
+	std::cout << "correctness: " << (ParalHull::sequential(timer, test1.begin(), test1.end(), getRefFromPtItr, false, 0, ParalHullBase::I_BRIO) == gt) << ". time: ";
 	std::cout << timer.stop() << std::endl;
 
+	std::cout << "------------------------------------\nsequential with conflict graph:\n";
+	timer.start();
+	std::cout << "correctness: " << (ParalHull::sequential(timer, test1.begin(), test1.end(), getRefFromPtItr, false, 0, ParalHullBase::I_CONFLICT) == gt) << ". time: ";
+	std::cout << timer.stop() << std::endl;
+
+	for (int nDir : {4, 8})
+	{
+		ParalHull::FilterStats stats;
+
+		std::cout << "------------------------------------\nsequentialWithFilter (" << nDir << " directions):\n";
+		timer.start();
+		std::cout << "correctness: " << (ParalHull::sequentialWithFilter(timer, test1.begin(), test1.end(), getRefFromPtItr, nDir, 0, &stats) == gt) << ". time: ";
+		std::cout << timer.stop() << std::endl;
+		std::cout << "extreme: " << stats.extreme << " filter: " << stats.filter << " hull: " << stats.hull
+			<< " survivors: " << stats.survivors << "/" << size << std::endl;
+
+		std::cout << "------------------------------------\nmanualParalWithFilter (" << nDir << " directions):\n";
+		timer.start();
+		std::cout << "correctness: " << (ParalHull::manualParalWithFilter(timer, test1.begin(), test1.end(), getRefFromPtItr, nDir, 0, &stats) == gt) << ". time: ";
+		std::cout << timer.stop() << std::endl;
+		std::cout << "extreme: " << stats.extreme << " filter: " << stats.filter << " hull: " << stats.hull
+			<< " survivors: " << stats.survivors << "/" << size << std::endl;
+	}
+
+	std::cout << "------------------------------------\nsequentialWithFilter float (4, 8 directions):\n";
+	{
+		auto getRefFromPtItrF = [](PointVecF::iterator itr){return &(*itr);};
+		PointVecF testF;
+		for (auto& p : test1) testF.push_back(p.cast<float>());
+		auto gtF = ParalHullF::sequential(timer, testF.begin(), testF.end(), getRefFromPtItrF);
+
+		timer.start();
+		bool correct = true;
+		for (int nDir : {4, 8})
+		{
+			correct &= ParalHullF::sequentialWithFilter(timer, testF.begin(), testF.end(), getRefFromPtItrF, nDir) == gtF;
+		}
+		std::cout << "correctness: " << correct << ". time: " << timer.stop() << std::endl;
+	}
+
+	std::cout << "------------------------------------\nhullStream (10 batches):\n";
+	{
+		HullStream stream;
+		bool correct = true;
+		int inserted = 0;
+		const int nBatch = 10;
+
+		timer.start();
+		for (int b = 0; b < nBatch; ++b)
+		{
+			auto first = test1.begin() + (long)size * b / nBatch, last = test1.begin() + (long)size * (b + 1) / nBatch;
+			inserted += stream.append(first, last, getRefFromPtItr);
+			correct &= stream.hull() == ParalHull::sequential(timer, test1.begin(), last, getRefFromPtItr);
+		}
+		auto cost = timer.stop();
+		correct &= stream.hull() == gt;
+		std::cout << "correctness: " << correct << ". time: " << cost << std::endl;
+		std::cout << "inserted: " << inserted << "/" << size << " kept: " << stream.size() << std::endl;
+	}
+
+	std::cout << "------------------------------------\nvisibility kernel (dropped outside, kept inside):\n";
+	{
+		Hull hull(size);
+		PointRefVec refs = ParalHull::getRefs(test1);
+		refs.resize(size / 2);
+		hull.insert(refs);
+		auto poly = hull.getPolygon();
+
+		Visibility::Facets facets;
+		hull.getFacets(facets);
+		const Val_t* coords[NDim];
+		std::vector<Val_t> xs[NDim];
+		for (int d = 0; d < NDim; ++d)
+		{
+			for (auto& p : test1) xs[d].push_back(p[d]);
+			coords[d] = xs[d].data();
+		}
+		std::vector<uint64_t> mask((size + 63) / 64);
+		Visibility::outside(coords, size, facets, mask.data());
+
+		int dropped = 0, kept = 0;
+		for (int i = 0; i < size; ++i)
+		{
+			bool out = mask[i / 64] >> (i % 64) & 1;
+			bool in = Polygon::inside(poly, test1[i]);
+			dropped += !out && !in;
+			kept += out && in;
+		}
+		std::cout << "correctness: " << (dropped == 0) << ". facets: " << facets.size() << " kept inside: " << kept << std::endl;
+	}
+
+	std::cout << "------------------------------------\nstructure of arrays (round trip, filter, hull, marginality):\n";
+	{
+		timer.start();
+		PointSoA soa(test1, ParalHull::getThrNum());
+		bool roundTrip = soa.toPoints(ParalHull::getThrNum()) == test1;
+		auto convCost = timer.stop();
+
+		ParalHull::FilterStats stats;
+		timer.start();
+		bool seq = ParalHull::sequentialWithFilter(timer, soa.view(), 8, 0, &stats) == gt;
+		bool paral = ParalHull::manualParalWithFilter(timer, soa.view(), 8, 0, &stats) == gt;
+		auto filterCost = timer.stop();
+
+		Hull hull(size);
+		PointRefVec refs = ParalHull::getRefs(test1);
+		hull.insert(refs, soa.view());
+		bool insert = ParalHull::getPts(hull.getPolygon()) == gt;
+
+		auto order = Marginality::order(soa.view(0, size / 2), ParalHull::getThrNum());
+		auto sorted = Marginality::sort(test1.begin(), test1.begin() + size / 2, getRefFromPtItr, ParalHull::getThrNum());
+		bool marginal = order.size() == sorted.size();
+		for (int i = 0; marginal && i < order.size(); ++i)
+		{
+			marginal = test1[order[i]] == sorted[i];
+		}
+
+		std::cout << "correctness: " << (roundTrip && seq && paral && insert && marginal) << ". convert: " << convCost
+			<< " filter and hull: " << filterCost << " survivors: " << stats.survivors << "/" << size << std::endl;
+	}
+
+	std::cout << "------------------------------------\nround policy (fixpoint, adaptive):\n";
+	ParalHull::setRoundLog(true);
+	for (auto policy : {ParalHull::fixpoint(), ParalHull::adaptive()})
+	{
+		timer.start();
+		bool correct = ParalHull::manualParal(timer, test1.begin(), test1.end(), getRefFromPtItr, false, 0, ParalHull::P_STATIC, policy) == gt;
+		auto cost = timer.stop();
+		std::cout << "correctness: " << correct << ". time: " << cost << std::endl;
+	}
+	ParalHull::setRoundLog(false);
+
+	std::cout << "------------------------------------\nfloat instantiation (manualParal, mergeParal, chan):\n";
+	{
+		auto getRefFromPtItrF = [](PointVecF::iterator itr){return &(*itr);};
+		PointVecF testF;
+		for (auto& p : test1) testF.push_back(p.cast<float>());
+
+		timer.start();
+		auto gtF = ParalHullF::sequential(timer, testF.begin(), testF.end(), getRefFromPtItrF);
+		bool correct = ParalHullF::manualParal(timer, testF.begin(), testF.end(), getRefFromPtItrF) == gtF;
+		correct &= ParalHullF::mergeParal(timer, testF.begin(), testF.end(), getRefFromPtItrF) == gtF;
+		correct &= ParalHullF::chan(timer, testF.begin(), testF.end(), getRefFromPtItrF) == gtF;
+		auto cost = timer.stop();
+
+		PointVecF gtCast;
+		for (auto& p : gt) gtCast.push_back(p.cast<float>());
+		std::cout << "correctness: " << correct << ". time: " << cost << " jaccard to double: " << gtF.jaccard(gtCast) << std::endl;
+	}
+
+	std::cout << "------------------------------------\nexact predicates (near-collinear input, every engine):\n";
+	{
+		predicates::resetStats();
+		ParalHull::manualParal(timer, test1.begin(), test1.end(), getRefFromPtItr);
+		auto randomStats = predicates::stats();
+
+		//points rounded onto the edges of a triangle, plus a few inside, most
+		//of them are hull candidates so keep it small
+		const Val_t corners[3][2] = {{-400.1, -300.3}, {450.7, -250.9}, {20.3, 480.1}};
+		const int nDegen = std::min(size, 20000);
+		PointVec degen;
+		for (int i = 0; i < nDegen; ++i)
+		{
+			const Val_t* a = corners[i % 3];
+			const Val_t* b = corners[(i + 1) % 3];
+			const Val_t t = (Val_t)(i / 3) / (nDegen / 3 + 1);
+			if (i % 7 == 0) degen.emplace_back((a[0] + b[0]) / 4 + t, (a[1] + b[1]) / 4 - t);
+			else degen.emplace_back(a[0] + t * (b[0] - a[0]), a[1] + t * (b[1] - a[1]));
+		}
+		std::random_shuffle(degen.begin(), degen.end());
+
+		predicates::resetStats();
+		timer.start();
+		auto gtDegen = ParalHull::sequential(timer, degen.begin(), degen.end(), getRefFromPtItr);
+		bool correct = ParalHull::manualParal(timer, degen.begin(), degen.end(), getRefFromPtItr) == gtDegen;
+		correct &= ParalHull::specuParal(timer, degen.begin(), degen.end(), getRefFromPtItr) == gtDegen;
+		correct &= ParalHull::mergeParal(timer, degen.begin(), degen.end(), getRefFromPtItr) == gtDegen;
+		correct &= ParalHull::monotoneChain(timer, degen.begin(), degen.end(), getRefFromPtItr) == gtDegen;
+		correct &= ParalHull::quickHull(timer, degen.begin(), degen.end(), getRefFromPtItr) == gtDegen;
+		correct &= ParalHull::chan(timer, degen.begin(), degen.end(), getRefFromPtItr) == gtDegen;
+		auto cost = timer.stop();
+		auto stats = predicates::stats();
+		std::cout << "correctness: " << correct << ". time: " << cost << " hull: " << gtDegen.size()
+			<< " exact: " << stats.exact << "/" << stats.tests << " (random input: " << randomStats.exact << "/" << randomStats.tests << ")" << std::endl;
+	}
+
+	std::cout << "------------------------------------\n3 dimensionality (cube corners, ball, sphere, every engine):\n";
+	{
+		auto getRefFromPtItr3 = [](PointVec3::iterator itr){return &(*itr);};
+		const int size3 = std::min(size, 2000); //3 dimensionality walks are much longer
+
+		//a flat, partly collinear start for the origin simplex, then points
+		//strictly inside a cube and its corners, so the hull is the corners
+		PointVec3 corners, cube;
+		for (int k = 0; k < 8; ++k)
+		{
+			corners.push_back(Traits3::Point(k & 1 ? 500 : -500, k & 2 ? 500 : -500, k & 4 ? 500 : -500));
+		}
+		for (int i = 0; i < size3; ++i)
+		{
+			Traits3::Point p(PointVec3::rand(), PointVec3::rand(), PointVec3::rand());
+			cube.push_back(p * 0.999);
+		}
+		cube.insert(cube.end(), corners.begin(), corners.end());
+		std::random_shuffle(cube.begin(), cube.end());
+		for (int i = 0; i < 16; ++i)
+		{
+			cube.insert(cube.begin() + i, Traits3::Point(i < 3 ? 10 * i : (i * 37) % 400 - 200, i < 3 ? 5 * i : (i * 91) % 400 - 200, -100));
+		}
+
+		timer.start();
+		bool correct = ParalHull3::sequential(timer, cube.begin(), cube.end(), getRefFromPtItr3) == corners;
+		correct &= ParalHull3::sequential(timer, cube.begin(), cube.end(), getRefFromPtItr3, true) == corners;
+		correct &= ParalHull3::sequential(timer, cube.begin(), cube.end(), getRefFromPtItr3, false, 0, ParalHullBase::I_BRIO) == corners;
+		correct &= ParalHull3::sequential(timer, cube.begin(), cube.end(), getRefFromPtItr3, false, 0, ParalHullBase::I_CONFLICT) == corners;
+		correct &= ParalHull3::manualParal(timer, cube.begin(), cube.end(), getRefFromPtItr3) == corners;
+		correct &= ParalHull3::manualParal(timer, cube.begin(), cube.end(), getRefFromPtItr3, false, 0, ParalHullBase::P_TASK) == corners;
+		correct &= ParalHull3::manualParal(timer, cube.begin(), cube.end(), getRefFromPtItr3, false, 0, ParalHullBase::P_SPATIAL) == corners;
+		correct &= ParalHull3::specuParal(timer, cube.begin(), cube.end(), getRefFromPtItr3) == corners;
+		correct &= ParalHull3::mergeParal(timer, cube.begin(), cube.end(), getRefFromPtItr3) == corners;
+		correct &= ParalHull3::sequentialWithFilter(timer, cube.begin(), cube.end(), getRefFromPtItr3) == corners;
+
+		//random ball, every engine against sequential
+		PointVec3 ball(size3, PointVec3::CIRCLE);
+		auto gt3 = ParalHull3::sequential(timer, ball.begin(), ball.end(), getRefFromPtItr3);
+		correct &= ParalHull3::sequential(timer, ball.begin(), ball.end(), getRefFromPtItr3, true) == gt3;
+		correct &= ParalHull3::sequential(timer, ball.begin(), ball.end(), getRefFromPtItr3, false, 0, ParalHullBase::I_BRIO) == gt3;
+		correct &= ParalHull3::sequential(timer, ball.begin(), ball.end(), getRefFromPtItr3, false, 0, ParalHullBase::I_CONFLICT) == gt3;
+		correct &= ParalHull3::manualParal(timer, ball.begin(), ball.end(), getRefFromPtItr3) == gt3;
+		correct &= ParalHull3::manualParal(timer, ball.begin(), ball.end(), getRefFromPtItr3, false, 0, ParalHullBase::P_TASK,
+			ParalHullBase::adaptive()) == gt3;
+		correct &= ParalHull3::specuParal(timer, ball.begin(), ball.end(), getRefFromPtItr3) == gt3;
+		correct &= ParalHull3::mergeParal(timer, ball.begin(), ball.end(), getRefFromPtItr3) == gt3;
+
+		//every point of a sphere is a peak, so reseeds alone cannot make room
+		PointVec3 sphere;
+		for (auto& p : ball) sphere.push_back(p.normalized() * 500);
+		auto gtSphere = ParalHull3::sequential(timer, sphere.begin(), sphere.end(), getRefFromPtItr3);
+		correct &= gtSphere.size() == sphere.size();
+		correct &= ParalHull3::specuParal(timer, sphere.begin(), sphere.end(), getRefFromPtItr3) == gtSphere;
+		correct &= ParalHull3::sequential(timer, sphere.begin(), sphere.end(), getRefFromPtItr3, false, 0,
+			ParalHullBase::I_CONFLICT) == gtSphere;
+		correct &= ParalHull3::manualParal(timer, sphere.begin(), sphere.end(), getRefFromPtItr3) == gtSphere;
+
+		auto cost = timer.stop();
+		std::cout << "correctness: " << correct << ". time: " << cost << " ball hull: " << gt3.size() << std::endl;
+	}
+
+	std::cout << "------------------------------------\nallocations (steady state insert 2D, 3D; block insert; speculative):\n";
+	{
+		PointVec disk(size, PointVec::CIRCLE);
+		PointVec3 ball(std::min(size, 2000), PointVec3::CIRCLE);
+		Hull hull, hullBlock;
+		Hull3 hull3;
+		long allocs = steadyAllocs(hull, disk, false);
+		long allocs3 = steadyAllocs(hull3, ball, false);
+		long allocsBlock = steadyAllocs(hullBlock, disk, true);
+		std::cout << "correctness: " << (allocs == 0 && allocs3 == 0 && allocsBlock == 0) << ". allocations: "
+			<< allocs << " " << allocs3 << " " << allocsBlock << std::endl;
+
+		//a speculative call allocates its round state, but no locate does
+		Hull hullSpecu;
+		PointVec half;
+		half.assign(disk.begin(), disk.begin() + size / 2);
+		long allocsHalf = steadyAllocs(hullSpecu, half, false, ParalHull::getThrNum());
+		long allocsFull = steadyAllocs(hullSpecu, disk, false, ParalHull::getThrNum());
+		std::cout << "correctness: " << (allocsHalf == allocsFull) << ". speculative allocations (half, all points): "
+			<< allocsHalf << " " << allocsFull << std::endl;
+	}
+
+	std::cout << "------------------------------------\nhull pool (manualParal cold, warm):\n";
+	{
+		ParalHull::releasePool();
+		timer.start();
+		bool cold = ParalHull::manualParal(timer, test1.begin(), test1.end(), getRefFromPtItr) == gt;
+		auto coldCost = timer.stop();
+		timer.start();
+		bool warm = ParalHull::manualParal(timer, test1.begin(), test1.end(), getRefFromPtItr) == gt;
+		auto warmCost = timer.stop();
+		std::cout << "correctness: " << (cold && warm) << ". time: " << coldCost << " " << warmCost << std::endl;
+	}
+
+	reportScaling(test1, gt);
+
 	std::cout << "------------------------------------\n";
 
 	int cnt = 0;
@@ -215,6 +666,67 @@ void testAlg(int seed, int size, int loop)
 			LOG_WARN << "manualParalWithPresort WA";
 			add = false;
 		}
+		if (ParalHull::specuParal(timer, test1.begin(), test1.end(), getRefFromPtItr) != gt)
+		{
+			LOG_WARN << "specuParal WA";
+			add = false;
+		}
+		if (ParalHull::mergeParal(timer, test1.begin(), test1.end(), getRefFromPtItr) != gt)
+		{
+			LOG_WARN << "mergeParal WA";
+			add = false;
+		}
+		if (ParalHull::monotoneChain(timer, test1.begin(), test1.end(), getRefFromPtItr) != gt)
+		{
+			LOG_WARN << "monotoneChain WA";
+			add = false;
+		}
+		if (ParalHull::quickHull(timer, test1.begin(), test1.end(), getRefFromPtItr) != gt)
+		{
+			LOG_WARN << "quickHull WA";
+			add = false;
+		}
+		if (ParalHull::chan(timer, test1.begin(), test1.end(), getRefFromPtItr) != gt)
+		{
+			LOG_WARN << "chan WA";
+			add = false;
+		}
+		if (ParalHull::manualParalWithFilter(timer, test1.begin(), test1.end(), getRefFromPtItr) != gt)
+		{
+			LOG_WARN << "manualParalWithFilter WA";
+			add = false;
+		}
+		if (ParalHull::getPts(ParalHull::manualParalRefs(timer, test1.begin(), test1.end(), getRefFromPtItr, true)) != gt)
+		{
+			LOG_WARN << "manualParalRefs WA";
+			add = false;
+		}
+		if (ParalHull::manualParal(timer, test1.begin(), test1.end(), getRefFromPtItr, false, 0, ParalHull::P_TASK) != gt)
+		{
+			LOG_WARN << "manualParal (task) WA";
+			add = false;
+		}
+		if (ParalHull::mergeParal(timer, test1.begin(), test1.end(), getRefFromPtItr, false, 0, ParalHull::P_TASK) != gt)
+		{
+			LOG_WARN << "mergeParal (task) WA";
+			add = false;
+		}
+		if (ParalHull::manualParal(timer, test1.begin(), test1.end(), getRefFromPtItr, false, 0, ParalHull::P_SPATIAL) != gt)
+		{
+			LOG_WARN << "manualParal (spatial) WA";
+			add = false;
+		}
+		if (ParalHull::manualParal(timer, test1.begin(), test1.end(), getRefFromPtItr, false, 0, ParalHull::P_STATIC,
+			ParalHull::adaptive(0.9, 0)) != gt)
+		{
+			LOG_WARN << "manualParal (adaptive) WA";
+			add = false;
+		}
+		if (ParalHull::mergeParal(timer, test1.begin(), test1.end(), getRefFromPtItr, false, 0, ParalHull::P_SPATIAL) != gt)
+		{
+			LOG_WARN << "mergeParal (spatial) WA";
+			add = false;
+		}
 		cnt += add;
 	}
 	std::cout << seed << " " << size << " " << (loop ? (double)cnt / loop : 0) << std::endl;
@@ -235,14 +747,14 @@ void testAlg()
 	const int nseed = 8;
 	const char split[] = "------------------------------------\n";
 
-	result_t total_result[nexp];
+	result_t total_result[nexp] = {};
 	int total_correct_cnt[nexp] = {0};
 
 	for (int seed = 4; seed <= 4; ++seed)
 	{
 		PointVec::initRand(seed);
 
-		result_t result[nexp];
+		result_t result[nexp] = {};
 		int size, loop;
 		double conf;
 
@@ -277,16 +789,46 @@ void testAlg()
 				auto r4 = ParalHull::sequential(timer, points.begin(), points.end(), getRefFromPtItr, true);
 				auto t4 = timer.stop();
 
+				timer.start();
+				auto r5 = ParalHull::specuParal(timer, points.begin(), points.end(), getRefFromPtItr);
+				auto t5 = timer.stop();
+
+				timer.start();
+				auto r6 = ParalHull::mergeParal(timer, points.begin(), points.end(), getRefFromPtItr);
+				auto t6 = timer.stop();
+
+				timer.start();
+				auto r7 = ParalHull::monotoneChain(timer, points.begin(), points.end(), getRefFromPtItr);
+				auto t7 = timer.stop();
+
+				timer.start();
+				auto r8 = ParalHull::quickHull(timer, points.begin(), points.end(), getRefFromPtItr);
+				auto t8 = timer.stop();
+
+				timer.start();
+				auto r9 = ParalHull::chan(timer, points.begin(), points.end(), getRefFromPtItr);
+				auto t9 = timer.stop();
+
 				if (r1 != gt) { LOG_WARN << seed << " " << j << " manualParalWithPresort WA: " << r1.jaccard(gt); valid = false; }
 				if (r2 != gt) { LOG_WARN << seed << " " << j << " manualParal WA: " << r2.jaccard(gt); valid = false; }
 				if (r3 != gt) { LOG_WARN << seed << " " << j << " sequential WA: " << r3.jaccard(gt); valid = false; }
 				if (r4 != gt) { LOG_WARN << seed << " " << j << " sequentialWithPresort WA: " << r4.jaccard(gt); valid = false; }
-				if (r1 == gt && r2 == gt && r3 == gt && r4 == gt)
+				if (r5 != gt) { LOG_WARN << seed << " " << j << " specuParal WA: " << r5.jaccard(gt); valid = false; }
+				if (r6 != gt) { LOG_WARN << seed << " " << j << " mergeParal WA: " << r6.jaccard(gt); valid = false; }
+				if (r7 != gt) { LOG_WARN << seed << " " << j << " monotoneChain WA: " << r7.jaccard(gt); valid = false; }
+				if (r8 != gt) { LOG_WARN << seed << " " << j << " quickHull WA: " << r8.jaccard(gt); valid = false; }
+				if (r9 != gt) { LOG_WARN << seed << " " << j << " chan WA: " << r9.jaccard(gt); valid = false; }
+				if (r1 == gt && r2 == gt && r3 == gt && r4 == gt && r5 == gt && r6 == gt && r7 == gt && r8 == gt && r9 == gt)
 				{
 					result[i].t1 += t1;
 					result[i].t2 += t2;
 					result[i].t3 += t3;
 					result[i].t4 += t4;
+					result[i].t5 += t5;
+					result[i].t6 += t6;
+					result[i].t7 += t7;
+					result[i].t8 += t8;
+					result[i].t9 += t9;
 					correct_cnt += valid;
 				}
 
@@ -313,7 +855,14 @@ void testAlg()
 				<< "manualParalWithPresort: " << result[i].t1 / correct_cnt << std::endl
 				<< "manualParal: " << result[i].t2 / correct_cnt << std::endl
 				<< "sequential: " << result[i].t3 / correct_cnt << std::endl
-				<< "sequentialWithPresort: " << result[i].t4 / correct_cnt << std::endl;
+				<< "sequentialWithPresort: " << result[i].t4 / correct_cnt << std::endl
+				<< "specuParal: " << result[i].t5 / correct_cnt << std::endl
+				<< "mergeParal: " << result[i].t6 / correct_cnt << std::endl
+				<< "monotoneChain: " << result[i].t7 / correct_cnt << std::endl
+				<< "quickHull: " << result[i].t8 / correct_cnt << std::endl
+				<< "chan: " << result[i].t9 / correct_cnt << std::endl;
+
+			reportScaling(points, gt);
 
 		}
 
@@ -323,6 +872,11 @@ void testAlg()
 			total_result[i].t2 += result[i].t2;
 			total_result[i].t3 += result[i].t3;
 			total_result[i].t4 += result[i].t4;
+			total_result[i].t5 += result[i].t5;
+			total_result[i].t6 += result[i].t6;
+			total_result[i].t7 += result[i].t7;
+			total_result[i].t8 += result[i].t8;
+			total_result[i].t9 += result[i].t9;
 		}
 
 	}
@@ -336,6 +890,380 @@ void testAlg()
 			<< "manualParalWithPresort: " << total_result[i].t1 / total_correct_cnt[i] << std::endl
 			<< "manualParal: " << total_result[i].t2 / total_correct_cnt[i] << std::endl
 			<< "sequential: " << total_result[i].t3 / total_correct_cnt[i] << std::endl
-			<< "sequentialWithPresort: " << total_result[i].t4 / total_correct_cnt[i] << std::endl;
+			<< "sequentialWithPresort: " << total_result[i].t4 / total_correct_cnt[i] << std::endl
+			<< "specuParal: " << total_result[i].t5 / total_correct_cnt[i] << std::endl
+			<< "mergeParal: " << total_result[i].t6 / total_correct_cnt[i] << std::endl
+			<< "monotoneChain: " << total_result[i].t7 / total_correct_cnt[i] << std::endl
+			<< "quickHull: " << total_result[i].t8 / total_correct_cnt[i] << std::endl
+			<< "chan: " << total_result[i].t9 / total_correct_cnt[i] << std::endl;
+	}
+}
+
+void testPartition(int seed, int size, int loop)
+{
+	auto getRefFromPtItr = [](PointVec::iterator itr){return &(*itr);};
+	Timer timer;
+
+	const PointVec::Dist dists[] = {PointVec::UNIFORM, PointVec::CLUSTER, PointVec::CIRCLE};
+	const char* names[] = {"uniform", "cluster", "circle"};
+
+	const ParalHull::Partition parts[] = {ParalHull::P_STATIC, ParalHull::P_TASK, ParalHull::P_SPATIAL};
+	const int nPart = 3;
+
+	std::cout << "partition (input: manualParal static task spatial, mergeParal static task spatial):\n";
+	for (int d = 0; d < 3; ++d)
+	{
+		PointVec::initRand(seed);
+		PointVec points(size, dists[d]);
+		auto gt = ParalHull::sequential(timer, points.begin(), points.end(), getRefFromPtItr);
+
+		unsigned long t[2 * nPart] = {0};
+		bool correct = true;
+		for (int i = 0; i < loop; ++i)
+		{
+			for (int k = 0; k < nPart; ++k)
+			{
+				timer.start();
+				correct &= ParalHull::manualParal(timer, points.begin(), points.end(), getRefFromPtItr, false, 0, parts[k]) == gt;
+				t[k] += timer.stop();
+
+				timer.start();
+				correct &= ParalHull::mergeParal(timer, points.begin(), points.end(), getRefFromPtItr, false, 0, parts[k]) == gt;
+				t[nPart + k] += timer.stop();
+			}
+		}
+
+		loop = std::max(loop, 1);
+		std::cout << names[d] << ":";
+		for (int k = 0; k < 2 * nPart; ++k) std::cout << " " << t[k] / loop;
+		if (!correct) std::cout << " (WA)";
+		std::cout << std::endl;
+	}
+}
+
+//
+// @brief: run every engine of PH on points loop times, accumulating
+// 		   times into t and checking each result against gt
+//
+template <typename PH>
+static bool timeEngines(typename PH::PointVec& points, const typename PH::PointVec& gt, int loop, unsigned long* t)
+{
+	auto getRefFromPtItr = [](typename PH::PointVec::iterator itr){return &(*itr);};
+	auto beg = points.begin(), end = points.end();
+	Timer timer;
+	bool correct = true;
+
+	for (int i = 0; i < loop; ++i)
+	{
+		timer.start();
+		correct &= PH::sequential(timer, beg, end, getRefFromPtItr) == gt;
+		t[0] += timer.stop();
+
+		timer.start();
+		correct &= PH::manualParal(timer, beg, end, getRefFromPtItr) == gt;
+		t[1] += timer.stop();
+
+		timer.start();
+		correct &= PH::specuParal(timer, beg, end, getRefFromPtItr) == gt;
+		t[2] += timer.stop();
+
+		timer.start();
+		correct &= PH::mergeParal(timer, beg, end, getRefFromPtItr) == gt;
+		t[3] += timer.stop();
+
+		timer.start();
+		correct &= PH::monotoneChain(timer, beg, end, getRefFromPtItr) == gt;
+		t[4] += timer.stop();
+
+		timer.start();
+		correct &= PH::quickHull(timer, beg, end, getRefFromPtItr) == gt;
+		t[5] += timer.stop();
+
+		timer.start();
+		correct &= PH::chan(timer, beg, end, getRefFromPtItr) == gt;
+		t[6] += timer.stop();
+	}
+	return correct;
+}
+
+void testTraits(int seed, int size, int loop)
+{
+	auto getRefFromPtItr = [](PointVec::iterator itr){return &(*itr);};
+	auto getRefFromPtItrF = [](PointVecF::iterator itr){return &(*itr);};
+	Timer timer;
+
+	PointVec::initRand(seed);
+	PointVec points(size);
+	PointVecF pointsF;
+	pointsF.reserve(size);
+	for (auto& p : points) pointsF.push_back(p.cast<float>());
+
+	auto gt = ParalHull::sequential(timer, points.begin(), points.end(), getRefFromPtItr);
+	auto gtF = ParalHullF::sequential(timer, pointsF.begin(), pointsF.end(), getRefFromPtItrF);
+
+	//the float hull may only differ from the double one by near-collinear vertices
+	PointVecF gtCast;
+	for (auto& p : gt) gtCast.push_back(p.cast<float>());
+
+	const int nEngine = 7;
+	unsigned long t[nEngine] = {0}, tF[nEngine] = {0};
+	bool correct = timeEngines<ParalHull>(points, gt, loop, t);
+	bool correctF = timeEngines<ParalHullF>(pointsF, gtF, loop, tF);
+
+	loop = std::max(loop, 1);
+	std::cout << "traits (scalar: sequential manualParal specuParal mergeParal monotoneChain quickHull chan):\n";
+	std::cout << "double:";
+	for (int k = 0; k < nEngine; ++k) std::cout << " " << t[k] / loop;
+	if (!correct) std::cout << " (WA)";
+	std::cout << std::endl << "float:";
+	for (int k = 0; k < nEngine; ++k) std::cout << " " << tF[k] / loop;
+	if (!correctF) std::cout << " (WA)";
+	std::cout << std::endl;
+	std::cout << "bytes per point: " << sizeof(Point) << " " << sizeof(ParalHullF::Point)
+		<< ", per simplex: " << sizeof(Hull::Simplex) << " " << sizeof(HullT<TraitsF>::Simplex)
+		<< ", hull jaccard: " << gtF.jaccard(gtCast) << std::endl;
+}
+
+//
+// @brief: time n base normals of random simplices in D dimensionality, by
+// 		   the compile time dispatch and by the LU kernel, checking that
+// 		   both normals are parallel
+//
+template <unsigned int D>
+static bool timeBaseNormal(int n, unsigned long* t)
+{
+	using Ops = mpblocks::clarkson93::SimplexOps<ExampleTraits2<Val_t, D>>;
+	using Matrix = typename Ops::Matrix;
+	using Vec = typename ExampleTraits2<Val_t, D>::Point;
+
+	const int nSimplex = 256;
+	std::vector<Matrix, Eigen::aligned_allocator<Matrix>> A(nSimplex);
+	for (auto& a : A) a = Matrix::Random();
+
+	Timer timer;
+	Vec nDispatch, nKernel;
+	Val_t sum = 0; //keeps the loops from being optimized away
+	bool correct = true;
+
+	timer.start();
+	for (int i = 0; i < n; ++i)
+	{
+		Ops::baseNormal(A[i % nSimplex], nDispatch, typename Ops::template DimTag<D>());
+		sum += nDispatch[0];
+	}
+	t[0] += timer.stop();
+
+	timer.start();
+	for (int i = 0; i < n; ++i)
+	{
+		Ops::baseKernel(A[i % nSimplex], nKernel);
+		sum += nKernel[0];
+	}
+	t[1] += timer.stop();
+
+	for (auto& a : A)
+	{
+		Ops::baseNormal(a, nDispatch, typename Ops::template DimTag<D>());
+		Ops::baseKernel(a, nKernel);
+		Val_t cos = nDispatch.normalized().dot(nKernel.normalized());
+		correct &= std::abs(std::abs(cos) - 1) < 1e-9;
+	}
+	return correct && sum == sum;
+}
+
+void testBaseNormal(int loop)
+{
+	const int n = 100000;
+	const int nDim = 5;
+	unsigned long t[nDim][2] = {{0}};
+	bool correct = true;
+
+	for (int i = 0; i < loop; ++i)
+	{
+		correct &= timeBaseNormal<2>(n, t[0]);
+		correct &= timeBaseNormal<3>(n, t[1]);
+		correct &= timeBaseNormal<4>(n, t[2]);
+		correct &= timeBaseNormal<5>(n, t[3]);
+		correct &= timeBaseNormal<6>(n, t[4]);
+	}
+
+	loop = std::max(loop, 1);
+	std::cout << "base normal (dimensionality: dispatch LU, per " << n << " simplices):\n";
+	for (int d = 0; d < nDim; ++d)
+	{
+		std::cout << d + 2 << ": " << t[d][0] / loop << " " << t[d][1] / loop << std::endl;
+	}
+	std::cout << "correctness: " << correct << std::endl;
+}
+
+//
+// @brief: time sequential with every insertion on points
+// @param: t: t[k] with Insertion k
+//
+template <typename PH>
+static bool timeInsertion(typename PH::PointVec& points, int loop, unsigned long* t)
+{
+	auto getRefFromPtItr = [](typename PH::PointVec::iterator itr){return &(*itr);};
+	Timer timer;
+	bool correct = true;
+
+	for (int i = 0; i < loop; ++i)
+	{
+		timer.start();
+		auto gt = PH::sequential(timer, points.begin(), points.end(), getRefFromPtItr);
+		t[0] += timer.stop();
+
+		timer.start();
+		correct &= PH::sequential(timer, points.begin(), points.end(), getRefFromPtItr, false, 0, ParalHullBase::I_BRIO) == gt;
+		t[1] += timer.stop();
+
+		timer.start();
+		correct &= PH::sequential(timer, points.begin(), points.end(), getRefFromPtItr, false, 0, ParalHullBase::I_CONFLICT) == gt;
+		t[2] += timer.stop();
+	}
+	return correct;
+}
+
+void testInsertion(int seed, int size, int loop)
+{
+	PointVec::initRand(seed);
+	PointVec square(size), disk(size, PointVec::CIRCLE);
+	PointVec3 ball(size, PointVec3::CIRCLE);
+
+	const int nIns = 3;
+	unsigned long t[3][nIns] = {{0}};
+	bool correct = timeInsertion<ParalHull>(square, loop, t[0]);
+	correct &= timeInsertion<ParalHull>(disk, loop, t[1]);
+	correct &= timeInsertion<ParalHull3>(ball, loop, t[2]);
+
+	loop = std::max(loop, 1);
+	const char* names[] = {"square", "disk", "ball"};
+	std::cout << "insertion (input: sequential walk, brio, conflict graph):\n";
+	for (int k = 0; k < 3; ++k)
+	{
+		std::cout << names[k] << ":";
+		for (int j = 0; j < nIns; ++j) std::cout << " " << t[k][j] / loop;
+		std::cout << std::endl;
+	}
+	std::cout << "correctness: " << correct << std::endl;
+}
+
+//
+// @brief: the vertex sort SimplexOps::finish replaced, for reference
+//
+template <typename Simplex>
+static void finishByMap(Simplex& S)
+{
+	auto peak = S.V[S.iPeak];
+	std::map<typename Simplex::PointRef, typename Simplex::SimplexRef> kv;
+	for (int i = 0; i < Simplex::NDim + 1; ++i) kv[S.V[i]] = S.N[i];
+
+	int i = 0;
+	for (auto pair : kv)
+	{
+		if (pair.first == peak) S.iPeak = i;
+		S.V[i] = pair.first;
+		S.N[i] = pair.second;
+		++i;
+	}
+}
+
+//
+// @brief: time n finishes of simplices with shuffled vertices, by
+// 		   SimplexOps::finish and by the map, checking they agree
+// @param: t: t[0] finish, t[1] map
+//
+template <typename Tr>
+static bool timeFinish(int n, unsigned long* t)
+{
+	using Ops = mpblocks::clarkson93::SimplexOps<Tr>;
+	using Simplex = typename Tr::Simplex;
+	const int nSimplex = 256;
+
+	std::vector<typename Tr::Point> pts(nSimplex + Tr::NDim + 1);
+	std::vector<Simplex> shuffled(nSimplex);
+	for (int k = 0; k < nSimplex; ++k)
+	{
+		Simplex& S = shuffled[k];
+		for (int i = 0; i < Tr::NDim + 1; ++i)
+		{
+			S.V[i] = &pts[(k * 7 + i * 13) % pts.size()];
+			S.N[i] = &shuffled[(k + i + 1) % nSimplex];
+		}
+		std::random_shuffle(S.V, S.V + Tr::NDim + 1);
+		S.iPeak = k % (Tr::NDim + 1);
 	}
-}
\ No newline at end of file
+
+	Ops ops;
+	Timer timer;
+	std::vector<Simplex> byOps(shuffled), byMap(shuffled);
+
+	timer.start();
+	for (int i = 0; i < n; ++i)
+	{
+		Simplex& S = byOps[i % nSimplex];
+		ops.finish(S);
+		std::swap(S.V[0], S.V[Tr::NDim]); //unsort it again
+	}
+	t[0] += timer.stop();
+
+	timer.start();
+	for (int i = 0; i < n; ++i)
+	{
+		Simplex& S = byMap[i % nSimplex];
+		finishByMap(S);
+		std::swap(S.V[0], S.V[Tr::NDim]);
+	}
+	t[1] += timer.stop();
+
+	bool correct = true;
+	for (int k = 0; k < nSimplex; ++k)
+	{
+		Simplex a = shuffled[k], b = shuffled[k];
+		ops.finish(a);
+		finishByMap(b);
+		correct &= a.iPeak == b.iPeak && a.V[a.iPeak] == shuffled[k].V[shuffled[k].iPeak];
+		for (int i = 0; i < Tr::NDim + 1; ++i)
+		{
+			correct &= a.V[i] == b.V[i] && a.N[i] == b.N[i];
+		}
+	}
+	return correct;
+}
+
+void testFinish(int seed, int size, int loop)
+{
+	const int n = 100000;
+	unsigned long t[2][2] = {{0}}, tIns[2] = {0};
+	bool correct = true;
+
+	PointVec::initRand(seed);
+	PointVec disk(size, PointVec::CIRCLE);
+	PointVec3 ball(size, PointVec3::CIRCLE);
+
+	Timer timer;
+	for (int i = 0; i < loop; ++i)
+	{
+		correct &= timeFinish<Traits>(n, t[0]);
+		correct &= timeFinish<Traits3>(n, t[1]);
+
+		Hull hull(size);
+		timer.start();
+		hull.insert(disk);
+		tIns[0] += timer.stop();
+
+		Hull3 hull3(size);
+		timer.start();
+		hull3.insert(ball);
+		tIns[1] += timer.stop();
+	}
+
+	loop = std::max(loop, 1);
+	std::cout << "finish (dimensionality: sort map, per " << n << " simplices; inserts per second):\n";
+	for (int d = 0; d < 2; ++d)
+	{
+		std::cout << d + 2 << ": " << t[d][0] / loop << " " << t[d][1] / loop << "; "
+			<< (tIns[d] ? size * 1000.0 * loop / tIns[d] : 0) << std::endl;
+	}
+	std::cout << "correctness: " << correct << std::endl;
+}
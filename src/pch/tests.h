@@ -24,4 +24,14 @@ void testAlg(int seed, int size, int loop = 1000);
 
 void testAlg();
 
+void testPartition(int seed, int size, int loop = 10);
+
+void testTraits(int seed, int size, int loop = 10);
+
+void testBaseNormal(int loop = 10);
+
+void testInsertion(int seed, int size, int loop = 10);
+
+void testFinish(int seed, int size, int loop = 10);
+
 #endif
\ No newline at end of file